@@ -0,0 +1,339 @@
+// Measures the input-to-present latency of a render loop end to end.
+// Key events are injected with mimas_inject_key at a known time, the loop renders a color that encodes the last key,
+// and the frames read back with mimas_begin_capture are searched for that color. The latency of a sample is the time
+// from the injection to the mimas_swap_buffers call of the first frame that shows the key.
+//
+// Modes:
+//   batched   - The loop polls, renders the state recorded by the key callback and swaps on every refresh.
+//   callbacks - The key callback requests a redraw, the loop waits for events and the redraw callback renders.
+// Each mode runs with the keys injected on the render thread right before it polls and from a separate input thread.
+//
+// Usage: latency [samples per mode]
+
+#include <mimas/mimas.h>
+#include <mimas/mimas_gl.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define NOMINMAX 1
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+#define LATENCY_APIENTRY __stdcall
+typedef HANDLE Latency_Thread;
+typedef CRITICAL_SECTION Latency_Mutex;
+#else
+#include <pthread.h>
+#include <time.h>
+#define LATENCY_APIENTRY
+typedef pthread_t Latency_Thread;
+typedef pthread_mutex_t Latency_Mutex;
+#endif
+
+#define GL_COLOR_BUFFER_BIT 0x00004000
+typedef void (LATENCY_APIENTRY* PFN_glClearColor)(float red, float green, float blue, float alpha);
+typedef void (LATENCY_APIENTRY* PFN_glClear)(mimas_u32 mask);
+
+// Samples that have not shown up in a captured frame after this long are counted as lost.
+#define LATENCY_TIMEOUT_NS 1000000000ULL
+#define LATENCY_CAPTURE_BUFFERS 4
+
+typedef struct {
+    Mimas_Window* window;
+    PFN_glClearColor glClearColor;
+    PFN_glClear glClear;
+    mimas_bool redraw_on_input;
+
+    // Color code of the last key event, written by the key callback.
+    mimas_u8 code;
+
+    // Guards the fields below, which the input thread shares with the render thread.
+    Latency_Mutex mutex;
+    mimas_u32 sample_count;
+    mimas_u32 injected;
+    // Injection that has not been found in a captured frame yet. 0 if there is none.
+    mimas_u64 pending_ns;
+    mimas_u8 pending_code;
+    mimas_bool stop;
+
+    mimas_u64* latencies;
+    mimas_u32 latency_count;
+    mimas_u32 lost;
+} Latency_App;
+
+static void init_mutex(Latency_Mutex* const mutex) {
+#if defined(_WIN32)
+    InitializeCriticalSection(mutex);
+#else
+    pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+static void destroy_mutex(Latency_Mutex* const mutex) {
+#if defined(_WIN32)
+    DeleteCriticalSection(mutex);
+#else
+    pthread_mutex_destroy(mutex);
+#endif
+}
+
+static void lock(Latency_Mutex* const mutex) {
+#if defined(_WIN32)
+    EnterCriticalSection(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+static void unlock(Latency_Mutex* const mutex) {
+#if defined(_WIN32)
+    LeaveCriticalSection(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+static void sleep_ms(mimas_u32 const milliseconds) {
+#if defined(_WIN32)
+    Sleep(milliseconds);
+#else
+    struct timespec const duration = {milliseconds / 1000, (long)(milliseconds % 1000) * 1000000L};
+    nanosleep(&duration, NULL);
+#endif
+}
+
+// Presses and releases alternate. Every press uses the next letter so that consecutive samples have different colors.
+static Mimas_Key get_sample_key(mimas_u32 const sample) {
+    return (Mimas_Key)(MIMAS_KEY_A + (sample / 2) % 26);
+}
+
+static mimas_u8 get_key_code(Mimas_Key const key, Mimas_Key_Action const action) {
+    return action == MIMAS_KEY_RELEASE ? 0 : (mimas_u8)((key - MIMAS_KEY_A + 1) * 9);
+}
+
+// Injects the next sample unless the previous one is still in flight.
+static void inject_next_sample(Latency_App* const app) {
+    lock(&app->mutex);
+    if(app->pending_ns == 0 && app->injected < app->sample_count) {
+        Mimas_Key const key = get_sample_key(app->injected);
+        Mimas_Key_Action const action = app->injected % 2 == 0 ? MIMAS_KEY_PRESS : MIMAS_KEY_RELEASE;
+        app->pending_code = get_key_code(key, action);
+        app->pending_ns = mimas_get_time_ns();
+        app->injected += 1;
+        mimas_inject_key(app->window, key, action);
+    }
+    unlock(&app->mutex);
+}
+
+// Emulates an input thread that delivers events at random times relative to the refresh.
+#if defined(_WIN32)
+static DWORD WINAPI input_thread(LPVOID const param) {
+#else
+static void* input_thread(void* const param) {
+#endif
+    Latency_App* const app = (Latency_App*)param;
+    for(;;) {
+        sleep_ms(1 + (mimas_u32)rand() % 20);
+        lock(&app->mutex);
+        mimas_bool const stop = app->stop;
+        unlock(&app->mutex);
+        if(stop) {
+            break;
+        }
+        inject_next_sample(app);
+    }
+    return 0;
+}
+
+static Latency_Thread start_input_thread(Latency_App* const app) {
+#if defined(_WIN32)
+    return CreateThread(NULL, 0, input_thread, app, 0, NULL);
+#else
+    pthread_t thread;
+    pthread_create(&thread, NULL, input_thread, app);
+    return thread;
+#endif
+}
+
+static void join_input_thread(Latency_App* const app, Latency_Thread const thread) {
+    lock(&app->mutex);
+    app->stop = mimas_true;
+    unlock(&app->mutex);
+#if defined(_WIN32)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+// Looks for the pending sample in the frames the GPU has finished reading back.
+static void collect_frames(Latency_App* const app) {
+    Mimas_Captured_Frame frame;
+    while(mimas_acquire_captured_frame(app->window, &frame)) {
+        mimas_u8 const code = ((mimas_u8 const*)frame.pixels)[0];
+        lock(&app->mutex);
+        if(app->pending_ns != 0 && frame.timestamp_ns >= app->pending_ns && code == app->pending_code) {
+            app->latencies[app->latency_count] = frame.timestamp_ns - app->pending_ns;
+            app->latency_count += 1;
+            app->pending_ns = 0;
+        }
+        unlock(&app->mutex);
+        mimas_release_captured_frame(&frame);
+    }
+
+    lock(&app->mutex);
+    if(app->pending_ns != 0 && mimas_get_time_ns() - app->pending_ns > LATENCY_TIMEOUT_NS) {
+        app->lost += 1;
+        app->pending_ns = 0;
+    }
+    unlock(&app->mutex);
+}
+
+static mimas_bool is_done(Latency_App* const app) {
+    lock(&app->mutex);
+    mimas_bool const done = app->latency_count + app->lost == app->sample_count;
+    unlock(&app->mutex);
+    return done;
+}
+
+static void render(Latency_App* const app) {
+    app->glClearColor(app->code / 255.0f, 0.0f, 0.0f, 1.0f);
+    app->glClear(GL_COLOR_BUFFER_BIT);
+    mimas_swap_buffers(app->window);
+    collect_frames(app);
+}
+
+static void key_callback(Mimas_Window* const window, Mimas_Key const key, Mimas_Key_Action const action, void* const user_data) {
+    Latency_App* const app = (Latency_App*)user_data;
+    if(key < MIMAS_KEY_A || key > MIMAS_KEY_Z || action == MIMAS_KEY_REPEAT) {
+        return;
+    }
+
+    app->code = get_key_code(key, action);
+    if(app->redraw_on_input) {
+        mimas_request_redraw(window);
+    }
+}
+
+static void redraw_callback(Mimas_Window* const window, void* const user_data) {
+    (void)window;
+    render((Latency_App*)user_data);
+}
+
+static int compare_latencies(void const* const a, void const* const b) {
+    mimas_u64 const x = *(mimas_u64 const*)a;
+    mimas_u64 const y = *(mimas_u64 const*)b;
+    return x < y ? -1 : x > y;
+}
+
+static double get_percentile_us(Latency_App const* const app, mimas_u32 const percent) {
+    mimas_u32 const index = (app->latency_count - 1) * percent / 100;
+    return app->latencies[index] / 1000.0;
+}
+
+static void run_mode(Latency_App* const app, mimas_bool const redraw_on_input, mimas_bool const threaded) {
+    app->redraw_on_input = redraw_on_input;
+    app->code = 0;
+    app->injected = 0;
+    app->pending_ns = 0;
+    app->stop = mimas_false;
+    app->latency_count = 0;
+    app->lost = 0;
+    mimas_set_window_redraw_callback(app->window, redraw_on_input ? redraw_callback : NULL, app);
+    mimas_reset_stats();
+
+    Latency_Thread thread;
+    memset(&thread, 0, sizeof(Latency_Thread));
+    if(threaded) {
+        thread = start_input_thread(app);
+    }
+
+    while(!is_done(app)) {
+        if(!threaded) {
+            inject_next_sample(app);
+        }
+
+        if(redraw_on_input) {
+            // Wake up regularly to retrieve the frames whose readback completes after the swap.
+            mimas_wait_events(1);
+            collect_frames(app);
+        } else {
+            mimas_poll_events();
+            render(app);
+        }
+    }
+
+    if(threaded) {
+        join_input_thread(app, thread);
+    }
+
+    Mimas_Stats stats;
+    mimas_get_window_stats(app->window, &stats);
+    Mimas_Histogram const* const reported = &stats.input_to_present_ns;
+    printf("%-9s %-12s samples %4u lost %3u", redraw_on_input ? "callbacks" : "batched", threaded ? "input thread" : "render thread", app->latency_count, app->lost);
+    if(app->latency_count > 0) {
+        qsort(app->latencies, app->latency_count, sizeof(mimas_u64), compare_latencies);
+        printf("  min %8.1f us  p50 %8.1f us  p90 %8.1f us  p99 %8.1f us  max %8.1f us", app->latencies[0] / 1000.0, get_percentile_us(app, 50),
+               get_percentile_us(app, 90), get_percentile_us(app, 99), app->latencies[app->latency_count - 1] / 1000.0);
+    }
+    // The library's own measurement ends at the same swap, so both should agree unless frames do not reflect their input.
+    if(reported->count > 0) {
+        printf("  stats mean %8.1f us", (double)reported->sum / reported->count / 1000.0);
+    }
+    printf("\n");
+}
+
+int main(int const argc, char** const argv) {
+    mimas_u32 const sample_count = argc > 1 ? (mimas_u32)strtoul(argv[1], NULL, 10) : 200;
+    if(sample_count == 0) {
+        fprintf(stderr, "usage: latency [samples per mode]\n");
+        return 1;
+    }
+
+    if(!mimas_init_with_gl()) {
+        fprintf(stderr, "Failed to initialize mimas with GL\n");
+        return 1;
+    }
+
+    Latency_App app;
+    memset(&app, 0, sizeof(Latency_App));
+    app.sample_count = sample_count;
+    app.latencies = (mimas_u64*)malloc(sizeof(mimas_u64) * sample_count);
+    init_mutex(&app.mutex);
+
+    app.window = mimas_create_window((Mimas_Window_Create_Info){.width = 640, .height = 360, .title = "mimas latency", .decorated = mimas_true});
+    Mimas_GL_Context* const ctx = app.window ? mimas_create_gl_context(3, 2, MIMAS_GL_CORE_PROFILE) : NULL;
+    if(!ctx || !mimas_make_context_current(app.window, ctx)) {
+        fprintf(stderr, "Failed to create a GL 3.2 context\n");
+        return 1;
+    }
+
+    app.glClearColor = (PFN_glClearColor)mimas_gl_get_proc_address("glClearColor");
+    app.glClear = (PFN_glClear)mimas_gl_get_proc_address("glClear");
+    if(!app.glClearColor || !app.glClear || !mimas_begin_capture(app.window, LATENCY_CAPTURE_BUFFERS)) {
+        fprintf(stderr, "Failed to start capturing the window\n");
+        return 1;
+    }
+
+    mimas_set_swap_interval(1);
+    mimas_set_window_key_callback(app.window, key_callback, &app);
+    mimas_show_window(app.window);
+    mimas_set_stats_enabled(mimas_true);
+
+    run_mode(&app, mimas_false, mimas_false);
+    run_mode(&app, mimas_false, mimas_true);
+    run_mode(&app, mimas_true, mimas_false);
+    run_mode(&app, mimas_true, mimas_true);
+
+    mimas_end_capture(app.window);
+    mimas_make_context_current(app.window, NULL);
+    mimas_destroy_gl_context(ctx);
+    mimas_destroy_window(app.window);
+    mimas_terminate();
+    destroy_mutex(&app.mutex);
+    free(app.latencies);
+    return 0;
+}
@@ -0,0 +1,128 @@
+#ifndef MIMAS_ATOMIC_H_INCLUDE
+#define MIMAS_ATOMIC_H_INCLUDE
+
+#include <mimas/mimas.h>
+#include <utils.h>
+
+#include <stddef.h>
+
+// Atomics used for counters and flags that are read from other threads.
+// Operations are relaxed unless stated otherwise in the name.
+// All operations are sequentially consistent on MSVC since the Interlocked intrinsics are full barriers.
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+
+    MIMAS_INLINE mimas_u64 _mimas_atomic_load_u64(mimas_u64 volatile* const p) {
+        return (mimas_u64)_InterlockedCompareExchange64((__int64 volatile*)p, 0, 0);
+    }
+
+    MIMAS_INLINE void _mimas_atomic_store_u64(mimas_u64 volatile* const p, mimas_u64 const value) {
+        __int64 expected = *(__int64 volatile*)p;
+        __int64 actual;
+        while((actual = _InterlockedCompareExchange64((__int64 volatile*)p, (__int64)value, expected)) != expected) {
+            expected = actual;
+        }
+    }
+
+    MIMAS_INLINE mimas_u64 _mimas_atomic_add_u64(mimas_u64 volatile* const p, mimas_u64 const value) {
+    #if defined(_M_IX86)
+        __int64 expected = *(__int64 volatile*)p;
+        __int64 actual;
+        while((actual = _InterlockedCompareExchange64((__int64 volatile*)p, expected + (__int64)value, expected)) != expected) {
+            expected = actual;
+        }
+        return (mimas_u64)expected + value;
+    #else
+        return (mimas_u64)_InterlockedExchangeAdd64((__int64 volatile*)p, (__int64)value) + value;
+    #endif
+    }
+
+    MIMAS_INLINE mimas_bool _mimas_atomic_cas_u64(mimas_u64 volatile* const p, mimas_u64 const expected, mimas_u64 const desired) {
+        return (mimas_u64)_InterlockedCompareExchange64((__int64 volatile*)p, (__int64)desired, (__int64)expected) == expected;
+    }
+
+    MIMAS_INLINE mimas_u64 _mimas_atomic_load_acquire_u64(mimas_u64 volatile* const p) {
+        return _mimas_atomic_load_u64(p);
+    }
+
+    MIMAS_INLINE void _mimas_atomic_store_release_u64(mimas_u64 volatile* const p, mimas_u64 const value) {
+        _mimas_atomic_store_u64(p, value);
+    }
+
+    MIMAS_INLINE void* _mimas_atomic_load_ptr(void* volatile* const p) {
+        return _InterlockedCompareExchangePointer(p, NULL, NULL);
+    }
+
+    MIMAS_INLINE mimas_bool _mimas_atomic_cas_ptr(void* volatile* const p, void* const expected, void* const desired) {
+        return _InterlockedCompareExchangePointer(p, desired, expected) == expected;
+    }
+
+    MIMAS_INLINE mimas_i32 _mimas_atomic_load_i32(mimas_i32 volatile* const p) {
+        return _InterlockedCompareExchange((long volatile*)p, 0, 0);
+    }
+
+    MIMAS_INLINE void _mimas_atomic_store_i32(mimas_i32 volatile* const p, mimas_i32 const value) {
+        _InterlockedExchange((long volatile*)p, value);
+    }
+
+    // Full memory barrier.
+    MIMAS_INLINE void _mimas_atomic_fence() {
+        long volatile barrier = 0;
+        _InterlockedOr(&barrier, 0);
+    }
+#else
+    MIMAS_INLINE mimas_u64 _mimas_atomic_load_u64(mimas_u64 volatile* const p) {
+        return __atomic_load_n(p, __ATOMIC_RELAXED);
+    }
+
+    MIMAS_INLINE void _mimas_atomic_store_u64(mimas_u64 volatile* const p, mimas_u64 const value) {
+        __atomic_store_n(p, value, __ATOMIC_RELAXED);
+    }
+
+    MIMAS_INLINE mimas_u64 _mimas_atomic_add_u64(mimas_u64 volatile* const p, mimas_u64 const value) {
+        return __atomic_add_fetch(p, value, __ATOMIC_RELAXED);
+    }
+
+    MIMAS_INLINE mimas_bool _mimas_atomic_cas_u64(mimas_u64 volatile* const p, mimas_u64 expected, mimas_u64 const desired) {
+        return __atomic_compare_exchange_n(p, &expected, desired, mimas_false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    }
+
+    MIMAS_INLINE mimas_u64 _mimas_atomic_load_acquire_u64(mimas_u64 volatile* const p) {
+        return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+    }
+
+    MIMAS_INLINE void _mimas_atomic_store_release_u64(mimas_u64 volatile* const p, mimas_u64 const value) {
+        __atomic_store_n(p, value, __ATOMIC_RELEASE);
+    }
+
+    MIMAS_INLINE void* _mimas_atomic_load_ptr(void* volatile* const p) {
+        return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+    }
+
+    MIMAS_INLINE mimas_bool _mimas_atomic_cas_ptr(void* volatile* const p, void* expected, void* const desired) {
+        return __atomic_compare_exchange_n(p, &expected, desired, mimas_false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    }
+
+    MIMAS_INLINE mimas_i32 _mimas_atomic_load_i32(mimas_i32 volatile* const p) {
+        return __atomic_load_n(p, __ATOMIC_RELAXED);
+    }
+
+    MIMAS_INLINE void _mimas_atomic_store_i32(mimas_i32 volatile* const p, mimas_i32 const value) {
+        __atomic_store_n(p, value, __ATOMIC_RELAXED);
+    }
+
+    // Full memory barrier.
+    MIMAS_INLINE void _mimas_atomic_fence() {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+#endif
+
+MIMAS_INLINE void _mimas_atomic_max_u64(mimas_u64 volatile* const p, mimas_u64 const value) {
+    mimas_u64 current = _mimas_atomic_load_u64(p);
+    while(current < value && !_mimas_atomic_cas_u64(p, current, value)) {
+        current = _mimas_atomic_load_u64(p);
+    }
+}
+
+#endif // !MIMAS_ATOMIC_H_INCLUDE
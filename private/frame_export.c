@@ -0,0 +1,382 @@
+#include <frame_export.h>
+#include <atomic.h>
+#include <internal.h>
+#include <platform.h>
+#include <trace.h>
+#include <utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+// Layout of the shared memory:
+//   Mimas_Frame_Export_Header
+//   Mimas_Frame_Export_Slot[slot_count]
+//   pixels of every slot, each slot_size bytes and aligned to MIMAS_FRAME_EXPORT_ALIGNMENT
+// All fields are mimas_u64 so that the layout is the same for 32 and 64 bit processes.
+
+#define MIMAS_FRAME_EXPORT_MAGIC 0x54524F5058454D4DULL
+#define MIMAS_FRAME_EXPORT_VERSION 1
+#define MIMAS_FRAME_EXPORT_ALIGNMENT 64
+
+typedef struct {
+    mimas_u64 magic;
+    mimas_u64 version;
+    mimas_u64 slot_count;
+    mimas_u64 slot_size;
+    mimas_u64 max_width;
+    mimas_u64 max_height;
+    // Sequence of the newest published frame. 0 if nothing has been published yet.
+    mimas_u64 volatile latest_sequence;
+} Mimas_Frame_Export_Header;
+
+typedef struct {
+    // Sequence of the frame in the slot. 0 while the slot is empty or being written.
+    mimas_u64 volatile sequence;
+    // Number of consumers that hold the slot.
+    mimas_u64 volatile readers;
+    mimas_u64 width;
+    mimas_u64 height;
+    mimas_u64 stride;
+    mimas_u64 timestamp_ns;
+    mimas_u64 frame_index;
+    // Offset of the pixels from the start of the shared memory.
+    mimas_u64 offset;
+} Mimas_Frame_Export_Slot;
+
+struct Mimas_Frame_Export {
+    void* memory_handle;
+    void* memory;
+    void* event;
+    mimas_u64 sequence;
+    mimas_u32 next_slot;
+};
+
+struct Mimas_Frame_Import {
+    void* memory_handle;
+    void* memory;
+    void* event;
+    mimas_u64 last_sequence;
+    // Copied from the header once it has been validated, so that the exporter cannot make us read past the mapping later.
+    mimas_u64 size;
+    mimas_u64 slot_size;
+    mimas_u32 slot_count;
+};
+
+static Mimas_Frame_Export_Slot* get_slots(void* const memory) {
+    return (Mimas_Frame_Export_Slot*)((char*)memory + sizeof(Mimas_Frame_Export_Header));
+}
+
+static mimas_u64 align_size(mimas_u64 const size) {
+    return (size + MIMAS_FRAME_EXPORT_ALIGNMENT - 1) & ~(mimas_u64)(MIMAS_FRAME_EXPORT_ALIGNMENT - 1);
+}
+
+// Names of the shared memory and the event of the export name. Returns mimas_false if name is too long.
+static mimas_bool make_names(char const* const name, char (*const memory_name)[256], char (*const event_name)[256]) {
+    int const memory_length = snprintf(*memory_name, sizeof(*memory_name), "mimas_frames_%s", name);
+    int const event_length = snprintf(*event_name, sizeof(*event_name), "mimas_frames_%s_ready", name);
+    return memory_length > 0 && memory_length < (int)sizeof(*memory_name) && event_length > 0 && event_length < (int)sizeof(*event_name);
+}
+
+Mimas_Frame_Export* mimas_create_frame_export(char const* const name, mimas_i32 const max_width, mimas_i32 const max_height, mimas_u32 const slot_count) {
+    if(max_width <= 0 || max_height <= 0 || slot_count == 0) {
+        // TODO: Error
+        return NULL;
+    }
+
+    char memory_name[256];
+    char event_name[256];
+    if(!make_names(name, &memory_name, &event_name)) {
+        // TODO: Error
+        return NULL;
+    }
+
+    mimas_u64 const slot_size = align_size((mimas_u64)max_width * (mimas_u64)max_height * 4);
+    mimas_u64 const pixels_offset = align_size(sizeof(Mimas_Frame_Export_Header) + sizeof(Mimas_Frame_Export_Slot) * slot_count);
+    mimas_u64 const size = pixels_offset + slot_size * slot_count;
+    void* memory_handle = NULL;
+    void* const memory = mimas_platform_create_shared_memory(memory_name, size, &memory_handle);
+    if(!memory) {
+        // TODO: Error
+        return NULL;
+    }
+
+    void* const event = mimas_platform_create_named_event(event_name);
+    if(!event) {
+        mimas_platform_close_shared_memory(memory_handle, memory);
+        // TODO: Error
+        return NULL;
+    }
+
+    // Fresh shared memory is zeroed, so the slots are empty and nothing has been published.
+    Mimas_Frame_Export_Slot* const slots = get_slots(memory);
+    for(mimas_u32 i = 0; i < slot_count; ++i) {
+        slots[i].offset = pixels_offset + slot_size * i;
+    }
+    Mimas_Frame_Export_Header* const header = (Mimas_Frame_Export_Header*)memory;
+    header->version = MIMAS_FRAME_EXPORT_VERSION;
+    header->slot_count = slot_count;
+    header->slot_size = slot_size;
+    header->max_width = (mimas_u64)max_width;
+    header->max_height = (mimas_u64)max_height;
+    // Consumers check the magic last, therefore it must become visible after the rest of the header.
+    _mimas_atomic_store_release_u64(&header->magic, MIMAS_FRAME_EXPORT_MAGIC);
+
+    Mimas_Frame_Export* const frame_export = (Mimas_Frame_Export*)_mimas_malloc(sizeof(Mimas_Frame_Export));
+    memset(frame_export, 0, sizeof(Mimas_Frame_Export));
+    frame_export->memory_handle = memory_handle;
+    frame_export->memory = memory;
+    frame_export->event = event;
+    return frame_export;
+}
+
+void mimas_destroy_frame_export(Mimas_Frame_Export* const frame_export) {
+    mimas_platform_close_named_event(frame_export->event);
+    mimas_platform_close_shared_memory(frame_export->memory_handle, frame_export->memory);
+    _mimas_free(frame_export);
+}
+
+// Takes the slot away from consumers. Fails if a consumer holds the slot or is about to acquire it.
+static mimas_bool claim_slot(Mimas_Frame_Export_Slot* const slot) {
+    if(_mimas_atomic_load_u64(&slot->readers) != 0) {
+        return mimas_false;
+    }
+
+    // A consumer increments readers and then checks the sequence, we clear the sequence and then check readers.
+    // With a full barrier between the two steps on both sides, at least one of us sees the other and backs off.
+    mimas_u64 const sequence = _mimas_atomic_load_u64(&slot->sequence);
+    _mimas_atomic_store_u64(&slot->sequence, 0);
+    _mimas_atomic_fence();
+    if(_mimas_atomic_load_u64(&slot->readers) != 0) {
+        _mimas_atomic_store_u64(&slot->sequence, sequence);
+        return mimas_false;
+    }
+    return mimas_true;
+}
+
+void* _mimas_claim_frame_export_slot(Mimas_Frame_Export* const frame_export, mimas_i32 const width, mimas_i32 const height, mimas_u32* const slot_index) {
+    Mimas_Frame_Export_Header* const header = (Mimas_Frame_Export_Header*)frame_export->memory;
+    if(width <= 0 || height <= 0 || (mimas_u64)width > header->max_width || (mimas_u64)height > header->max_height) {
+        // TODO: Error
+        return NULL;
+    }
+
+    Mimas_Frame_Export_Slot* const slots = get_slots(frame_export->memory);
+    mimas_u32 const slot_count = (mimas_u32)header->slot_count;
+    for(mimas_u32 i = 0; i < slot_count; ++i) {
+        mimas_u32 const index = (frame_export->next_slot + i) % slot_count;
+        if(claim_slot(&slots[index])) {
+            frame_export->next_slot = (index + 1) % slot_count;
+            *slot_index = index;
+            return (char*)frame_export->memory + slots[index].offset;
+        }
+    }
+    return NULL;
+}
+
+void _mimas_publish_frame_export_slot(Mimas_Frame_Export* const frame_export, mimas_u32 const slot_index, mimas_i32 const width, mimas_i32 const height,
+                                      mimas_u64 const timestamp_ns, mimas_u64 const frame_index) {
+    Mimas_Frame_Export_Header* const header = (Mimas_Frame_Export_Header*)frame_export->memory;
+    Mimas_Frame_Export_Slot* const slot = &get_slots(frame_export->memory)[slot_index];
+    slot->width = (mimas_u64)width;
+    slot->height = (mimas_u64)height;
+    slot->stride = (mimas_u64)width * 4;
+    slot->timestamp_ns = timestamp_ns;
+    slot->frame_index = frame_index;
+
+    frame_export->sequence += 1;
+    _mimas_atomic_store_release_u64(&slot->sequence, frame_export->sequence);
+    _mimas_atomic_store_release_u64(&header->latest_sequence, frame_export->sequence);
+    mimas_platform_signal_named_event(frame_export->event);
+}
+
+mimas_bool mimas_export_frame(Mimas_Frame_Export* const frame_export, Mimas_Exported_Frame const* const frame) {
+    _mimas_trace_begin("mimas_export_frame");
+    mimas_u32 slot_index = 0;
+    char* const dst = (char*)_mimas_claim_frame_export_slot(frame_export, frame->width, frame->height, &slot_index);
+    if(!dst) {
+        _mimas_trace_end("mimas_export_frame");
+        return mimas_false;
+    }
+
+    mimas_u64 const row_size = (mimas_u64)frame->width * 4;
+    char const* const src = (char const*)frame->pixels;
+    if((mimas_u64)frame->stride == row_size) {
+        memcpy(dst, src, row_size * (mimas_u64)frame->height);
+    } else {
+        for(mimas_i32 y = 0; y < frame->height; ++y) {
+            memcpy(dst + row_size * y, src + (mimas_u64)frame->stride * y, row_size);
+        }
+    }
+    _mimas_publish_frame_export_slot(frame_export, slot_index, frame->width, frame->height, frame->timestamp_ns, frame->frame_index);
+    _mimas_trace_end("mimas_export_frame");
+    return mimas_true;
+}
+
+// The exporter is another process, therefore we check that every slot lies within the mapping before we trust the layout.
+static mimas_bool is_layout_valid(void* const memory, mimas_u64 const size) {
+    if(size < sizeof(Mimas_Frame_Export_Header)) {
+        return mimas_false;
+    }
+
+    Mimas_Frame_Export_Header const* const header = (Mimas_Frame_Export_Header const*)memory;
+    mimas_u64 const slot_count = header->slot_count;
+    mimas_u64 const slot_size = header->slot_size;
+    if(slot_count == 0 || slot_count > 0xFFFFFFFF || slot_count > (size - sizeof(Mimas_Frame_Export_Header)) / sizeof(Mimas_Frame_Export_Slot)) {
+        return mimas_false;
+    }
+
+    Mimas_Frame_Export_Slot const* const slots = get_slots(memory);
+    for(mimas_u64 i = 0; i < slot_count; ++i) {
+        if(slots[i].offset > size || slot_size > size - slots[i].offset) {
+            return mimas_false;
+        }
+    }
+    return mimas_true;
+}
+
+// Checks that the pixels of a published slot lie within the slot and fit the fields of Mimas_Exported_Frame.
+static mimas_bool is_slot_valid(Mimas_Frame_Import const* const frame_import, Mimas_Frame_Export_Slot const* const slot) {
+    mimas_u64 const offset = slot->offset;
+    mimas_u64 const row_size = slot->stride;
+    mimas_u64 const height = slot->height;
+    return offset <= frame_import->size && frame_import->slot_size <= frame_import->size - offset && slot->width > 0 &&
+           height > 0 && row_size == slot->width * 4 && row_size <= 0x7FFFFFFF && height <= 0x7FFFFFFF && row_size <= frame_import->slot_size / height;
+}
+
+Mimas_Frame_Import* mimas_open_frame_import(char const* const name) {
+    char memory_name[256];
+    char event_name[256];
+    if(!make_names(name, &memory_name, &event_name)) {
+        // TODO: Error
+        return NULL;
+    }
+
+    void* memory_handle = NULL;
+    mimas_u64 size = 0;
+    void* const memory = mimas_platform_open_shared_memory(memory_name, &memory_handle, &size);
+    if(!memory) {
+        return NULL;
+    }
+
+    Mimas_Frame_Export_Header* const header = (Mimas_Frame_Export_Header*)memory;
+    if(size < sizeof(Mimas_Frame_Export_Header) || _mimas_atomic_load_acquire_u64(&header->magic) != MIMAS_FRAME_EXPORT_MAGIC ||
+       header->version != MIMAS_FRAME_EXPORT_VERSION || !is_layout_valid(memory, size)) {
+        mimas_platform_close_shared_memory(memory_handle, memory);
+        // TODO: Error
+        return NULL;
+    }
+
+    void* const event = mimas_platform_open_named_event(event_name);
+    if(!event) {
+        mimas_platform_close_shared_memory(memory_handle, memory);
+        // TODO: Error
+        return NULL;
+    }
+
+    Mimas_Frame_Import* const frame_import = (Mimas_Frame_Import*)_mimas_malloc(sizeof(Mimas_Frame_Import));
+    if(!frame_import) {
+        mimas_platform_close_named_event(event);
+        mimas_platform_close_shared_memory(memory_handle, memory);
+        // TODO: Error
+        return NULL;
+    }
+
+    memset(frame_import, 0, sizeof(Mimas_Frame_Import));
+    frame_import->memory_handle = memory_handle;
+    frame_import->memory = memory;
+    frame_import->event = event;
+    frame_import->size = size;
+    frame_import->slot_size = header->slot_size;
+    frame_import->slot_count = (mimas_u32)header->slot_count;
+    return frame_import;
+}
+
+void mimas_close_frame_import(Mimas_Frame_Import* const frame_import) {
+    mimas_platform_close_named_event(frame_import->event);
+    mimas_platform_close_shared_memory(frame_import->memory_handle, frame_import->memory);
+    _mimas_free(frame_import);
+}
+
+static mimas_bool has_new_frame(Mimas_Frame_Import* const frame_import) {
+    Mimas_Frame_Export_Header* const header = (Mimas_Frame_Export_Header*)frame_import->memory;
+    return _mimas_atomic_load_acquire_u64(&header->latest_sequence) > frame_import->last_sequence;
+}
+
+mimas_bool mimas_wait_exported_frame(Mimas_Frame_Import* const frame_import, mimas_u32 const timeout_ms) {
+    if(has_new_frame(frame_import)) {
+        return mimas_true;
+    }
+
+    // The event may still be signalled for a frame we have already acquired, so we check the sequence again after waking up.
+    mimas_u64 const start = mimas_platform_get_time_ns();
+    mimas_u32 remaining = timeout_ms;
+    while(mimas_platform_wait_named_event(frame_import->event, remaining)) {
+        if(has_new_frame(frame_import)) {
+            return mimas_true;
+        }
+
+        if(timeout_ms != MIMAS_WAIT_FOREVER) {
+            mimas_u64 const elapsed_ms = (mimas_platform_get_time_ns() - start) / 1000000;
+            if(elapsed_ms >= timeout_ms) {
+                return mimas_false;
+            }
+            remaining = timeout_ms - (mimas_u32)elapsed_ms;
+        }
+    }
+    return has_new_frame(frame_import);
+}
+
+mimas_bool mimas_acquire_exported_frame(Mimas_Frame_Import* const frame_import, Mimas_Exported_Frame* const frame) {
+    Mimas_Frame_Export_Slot* const slots = get_slots(frame_import->memory);
+    mimas_u32 const slot_count = frame_import->slot_count;
+    // The exporter may reuse the newest slot between our scan and the acquisition, in which case we scan again.
+    // Every retry is caused by a newly published frame, so the loop ends once the exporter pauses or all slots are held.
+    for(;;) {
+        mimas_u32 newest = slot_count;
+        mimas_u64 newest_sequence = frame_import->last_sequence;
+        for(mimas_u32 i = 0; i < slot_count; ++i) {
+            mimas_u64 const sequence = _mimas_atomic_load_acquire_u64(&slots[i].sequence);
+            if(sequence > newest_sequence) {
+                newest = i;
+                newest_sequence = sequence;
+            }
+        }
+        if(newest == slot_count) {
+            return mimas_false;
+        }
+
+        Mimas_Frame_Export_Slot* const slot = &slots[newest];
+        _mimas_atomic_add_u64(&slot->readers, 1);
+        _mimas_atomic_fence();
+        if(_mimas_atomic_load_acquire_u64(&slot->sequence) != newest_sequence) {
+            _mimas_atomic_add_u64(&slot->readers, (mimas_u64)-1);
+            continue;
+        }
+
+        // The slot is ours now, so we copy its description once and only use the copy that we have checked.
+        frame_import->last_sequence = newest_sequence;
+        Mimas_Frame_Export_Slot const held = *slot;
+        if(!is_slot_valid(frame_import, &held)) {
+            _mimas_atomic_add_u64(&slot->readers, (mimas_u64)-1);
+            // TODO: Error
+            return mimas_false;
+        }
+
+        frame->pixels = (char const*)frame_import->memory + held.offset;
+        frame->width = (mimas_i32)held.width;
+        frame->height = (mimas_i32)held.height;
+        frame->stride = (mimas_i32)held.stride;
+        frame->timestamp_ns = held.timestamp_ns;
+        frame->frame_index = held.frame_index;
+        frame->sequence = newest_sequence;
+        frame->slot = newest;
+        return mimas_true;
+    }
+}
+
+void mimas_release_exported_frame(Mimas_Frame_Import* const frame_import, Mimas_Exported_Frame const* const frame) {
+    Mimas_Frame_Export_Slot* const slots = get_slots(frame_import->memory);
+    // Orders our reads of the pixels before the exporter may claim the slot.
+    _mimas_atomic_fence();
+    _mimas_atomic_add_u64(&slots[frame->slot].readers, (mimas_u64)-1);
+}
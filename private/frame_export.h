@@ -0,0 +1,13 @@
+#ifndef MIMAS_FRAME_EXPORT_H_INCLUDE
+#define MIMAS_FRAME_EXPORT_H_INCLUDE
+
+#include <mimas/mimas.h>
+
+// Claims a free slot for a width x height frame so that the caller can write the pixels in place.
+// Rows are width * 4 bytes apart. Returns NULL if the frame is larger than the slots or every slot is held by consumers.
+void* _mimas_claim_frame_export_slot(Mimas_Frame_Export* frame_export, mimas_i32 width, mimas_i32 height, mimas_u32* slot_index);
+// Publishes a slot claimed with _mimas_claim_frame_export_slot and wakes a waiting consumer.
+void _mimas_publish_frame_export_slot(Mimas_Frame_Export* frame_export, mimas_u32 slot_index, mimas_i32 width, mimas_i32 height,
+                                      mimas_u64 timestamp_ns, mimas_u64 frame_index);
+
+#endif // !MIMAS_FRAME_EXPORT_H_INCLUDE
@@ -0,0 +1,357 @@
+#include <gl_capture.h>
+#include <atomic.h>
+#include <frame_export.h>
+#include <internal.h>
+#include <platform.h>
+#include <trace.h>
+#include <utils.h>
+
+#include <string.h>
+
+// We do not depend on GL headers, therefore we declare the few types, enums and entry points the capture needs.
+#if defined(_WIN32) && !defined(_WIN64)
+    #define MIMAS_GL_APIENTRY __stdcall
+#else
+    #define MIMAS_GL_APIENTRY
+#endif
+
+typedef void* Mimas_GLsync;
+
+#define MIMAS_GL_RGBA                       0x1908
+#define MIMAS_GL_UNSIGNED_BYTE              0x1401
+#define MIMAS_GL_BACK                       0x0405
+#define MIMAS_GL_READ_BUFFER                0x0C02
+#define MIMAS_GL_PACK_ALIGNMENT             0x0D05
+#define MIMAS_GL_PIXEL_PACK_BUFFER          0x88EB
+#define MIMAS_GL_PIXEL_PACK_BUFFER_BINDING  0x88ED
+#define MIMAS_GL_READ_FRAMEBUFFER           0x8CA8
+#define MIMAS_GL_READ_FRAMEBUFFER_BINDING   0x8CAA
+#define MIMAS_GL_STREAM_READ                0x88E1
+#define MIMAS_GL_MAP_READ_BIT               0x0001
+#define MIMAS_GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define MIMAS_GL_ALREADY_SIGNALED           0x911A
+#define MIMAS_GL_CONDITION_SATISFIED        0x911C
+
+typedef struct {
+    void (MIMAS_GL_APIENTRY* GenBuffers)(mimas_i32 n, mimas_u32* buffers);
+    void (MIMAS_GL_APIENTRY* DeleteBuffers)(mimas_i32 n, mimas_u32 const* buffers);
+    void (MIMAS_GL_APIENTRY* BindBuffer)(mimas_u32 target, mimas_u32 buffer);
+    void (MIMAS_GL_APIENTRY* BufferData)(mimas_u32 target, ptrdiff_t size, void const* data, mimas_u32 usage);
+    void* (MIMAS_GL_APIENTRY* MapBufferRange)(mimas_u32 target, ptrdiff_t offset, ptrdiff_t length, mimas_u32 access);
+    mimas_u8 (MIMAS_GL_APIENTRY* UnmapBuffer)(mimas_u32 target);
+    void (MIMAS_GL_APIENTRY* BindFramebuffer)(mimas_u32 target, mimas_u32 framebuffer);
+    void (MIMAS_GL_APIENTRY* ReadBuffer)(mimas_u32 mode);
+    void (MIMAS_GL_APIENTRY* ReadPixels)(mimas_i32 x, mimas_i32 y, mimas_i32 width, mimas_i32 height, mimas_u32 format, mimas_u32 type, void* pixels);
+    void (MIMAS_GL_APIENTRY* PixelStorei)(mimas_u32 pname, mimas_i32 param);
+    void (MIMAS_GL_APIENTRY* GetIntegerv)(mimas_u32 pname, mimas_i32* data);
+    Mimas_GLsync (MIMAS_GL_APIENTRY* FenceSync)(mimas_u32 condition, mimas_u32 flags);
+    mimas_u32 (MIMAS_GL_APIENTRY* ClientWaitSync)(Mimas_GLsync sync, mimas_u32 flags, mimas_u64 timeout);
+    void (MIMAS_GL_APIENTRY* DeleteSync)(Mimas_GLsync sync);
+} Mimas_GL_Capture_Procs;
+
+static char const* const capture_proc_names[] = {
+    "glGenBuffers",
+    "glDeleteBuffers",
+    "glBindBuffer",
+    "glBufferData",
+    "glMapBufferRange",
+    "glUnmapBuffer",
+    "glBindFramebuffer",
+    "glReadBuffer",
+    "glReadPixels",
+    "glPixelStorei",
+    "glGetIntegerv",
+    "glFenceSync",
+    "glClientWaitSync",
+    "glDeleteSync",
+};
+
+// A pixel pack buffer that receives one frame, and the fence that signals when the copy has completed.
+typedef struct {
+    mimas_u32 buffer;
+    // NULL if the buffer is not in flight.
+    Mimas_GLsync fence;
+    mimas_u64 size;
+    mimas_i32 width;
+    mimas_i32 height;
+    mimas_u64 timestamp_ns;
+    mimas_u64 frame_index;
+} Mimas_GL_Capture_Slot;
+
+// CPU copy of a completed frame. Owned by the user between acquire and release.
+typedef struct {
+    void* pixels;
+    mimas_u64 capacity;
+    mimas_i32 volatile in_use;
+} Mimas_GL_Captured_Frame_Storage;
+
+typedef struct Mimas_GL_Capture {
+    Mimas_GL_Capture_Procs gl;
+    // Ring of slots. Frames are queued at head and completed in order from tail.
+    Mimas_GL_Capture_Slot* slots;
+    Mimas_GL_Captured_Frame_Storage* frames;
+    mimas_u32 slot_count;
+    mimas_u32 head;
+    mimas_u32 tail;
+    mimas_u32 pending;
+    mimas_u64 next_frame_index;
+    mimas_u64 dropped_frames;
+    // If set, completed frames are copied from the mapped buffers straight into the export's slots.
+    Mimas_Frame_Export* frame_export;
+} Mimas_GL_Capture;
+
+static void delete_capture(Mimas_GL_Capture* const capture, mimas_bool const delete_gl_objects) {
+    for(mimas_u32 i = 0; i < capture->slot_count; ++i) {
+        Mimas_GL_Capture_Slot* const slot = &capture->slots[i];
+        if(delete_gl_objects) {
+            if(slot->fence) {
+                capture->gl.DeleteSync(slot->fence);
+            }
+            capture->gl.DeleteBuffers(1, &slot->buffer);
+        }
+        _mimas_free(capture->frames[i].pixels);
+    }
+    _mimas_free(capture->slots);
+    _mimas_free(capture->frames);
+    _mimas_free(capture);
+}
+
+mimas_bool mimas_begin_capture(Mimas_Window* const window, mimas_u32 const buffer_count) {
+    if(window->capture || buffer_count == 0) {
+        // TODO: Error
+        return mimas_false;
+    }
+
+    Mimas_GL_Capture* const capture = (Mimas_GL_Capture*)_mimas_malloc(sizeof(Mimas_GL_Capture));
+    memset(capture, 0, sizeof(Mimas_GL_Capture));
+    // Fence syncs and MapBufferRange need GL 3.2. If any entry point is missing, the context cannot capture.
+    Mimas_GL_Proc* const procs = (Mimas_GL_Proc*)&capture->gl;
+    if(mimas_gl_load_procs(capture_proc_names, ARRAY_SIZE(capture_proc_names), procs) != ARRAY_SIZE(capture_proc_names)) {
+        _mimas_free(capture);
+        // TODO: Error
+        return mimas_false;
+    }
+
+    capture->slot_count = buffer_count;
+    capture->slots = (Mimas_GL_Capture_Slot*)_mimas_malloc(sizeof(Mimas_GL_Capture_Slot) * buffer_count);
+    memset(capture->slots, 0, sizeof(Mimas_GL_Capture_Slot) * buffer_count);
+    capture->frames = (Mimas_GL_Captured_Frame_Storage*)_mimas_malloc(sizeof(Mimas_GL_Captured_Frame_Storage) * buffer_count);
+    memset(capture->frames, 0, sizeof(Mimas_GL_Captured_Frame_Storage) * buffer_count);
+    for(mimas_u32 i = 0; i < buffer_count; ++i) {
+        capture->gl.GenBuffers(1, &capture->slots[i].buffer);
+    }
+    window->capture = capture;
+    return mimas_true;
+}
+
+void mimas_end_capture(Mimas_Window* const window) {
+    if(!window->capture) {
+        return;
+    }
+
+    delete_capture(window->capture, mimas_true);
+    window->capture = NULL;
+}
+
+void _mimas_gl_free_capture(Mimas_Window* const window) {
+    if(!window->capture) {
+        return;
+    }
+
+    // The GL objects belong to the context, which may not be current anymore. They are released with the context.
+    delete_capture(window->capture, mimas_false);
+    window->capture = NULL;
+}
+
+// Polls the fence of the slot. Timeout 0 never blocks.
+static mimas_bool is_slot_complete(Mimas_GL_Capture const* const capture, Mimas_GL_Capture_Slot const* const slot) {
+    mimas_u32 const status = capture->gl.ClientWaitSync(slot->fence, 0, 0);
+    return status == MIMAS_GL_ALREADY_SIGNALED || status == MIMAS_GL_CONDITION_SATISFIED;
+}
+
+// Retires the oldest slot in flight once its pixels have been consumed.
+static void retire_tail_slot(Mimas_GL_Capture* const capture) {
+    Mimas_GL_Capture_Slot* const slot = &capture->slots[capture->tail];
+    capture->gl.DeleteSync(slot->fence);
+    slot->fence = NULL;
+    capture->tail = (capture->tail + 1) % capture->slot_count;
+    capture->pending -= 1;
+}
+
+// Publishes every completed slot to the export. The mapped buffer is copied into the shared slot, there is no intermediate CPU copy.
+static void export_completed_frames(Mimas_GL_Capture* const capture) {
+    Mimas_GL_Capture_Procs const* const gl = &capture->gl;
+    while(capture->pending > 0 && is_slot_complete(capture, &capture->slots[capture->tail])) {
+        _mimas_trace_begin("export_completed_frames");
+        Mimas_GL_Capture_Slot* const slot = &capture->slots[capture->tail];
+        mimas_u32 slot_index = 0;
+        void* const dst = _mimas_claim_frame_export_slot(capture->frame_export, slot->width, slot->height, &slot_index);
+        if(dst) {
+            mimas_i32 prev_pack_buffer = 0;
+            gl->GetIntegerv(MIMAS_GL_PIXEL_PACK_BUFFER_BINDING, &prev_pack_buffer);
+            gl->BindBuffer(MIMAS_GL_PIXEL_PACK_BUFFER, slot->buffer);
+            void const* const mapped = gl->MapBufferRange(MIMAS_GL_PIXEL_PACK_BUFFER, 0, (ptrdiff_t)slot->size, MIMAS_GL_MAP_READ_BIT);
+            if(mapped) {
+                memcpy(dst, mapped, slot->size);
+                gl->UnmapBuffer(MIMAS_GL_PIXEL_PACK_BUFFER);
+            }
+            gl->BindBuffer(MIMAS_GL_PIXEL_PACK_BUFFER, (mimas_u32)prev_pack_buffer);
+            if(!mapped) {
+                // The claimed slot stays empty and is reused by the next frame.
+                // TODO: Error
+            } else {
+                _mimas_publish_frame_export_slot(capture->frame_export, slot_index, slot->width, slot->height, slot->timestamp_ns, slot->frame_index);
+            }
+        } else {
+            // Every shared slot is held by consumers or the frame does not fit. It shows up as a gap in frame_index.
+            capture->dropped_frames += 1;
+        }
+        retire_tail_slot(capture);
+        _mimas_trace_end("export_completed_frames");
+    }
+}
+
+void _mimas_gl_capture_frame(Mimas_Window* const window) {
+    Mimas_GL_Capture* const capture = window->capture;
+    if(capture->frame_export) {
+        // Frees the slots of completed frames before we look for a slot for this one.
+        export_completed_frames(capture);
+    }
+
+    // We never wait for the GPU here. If every slot is still in flight, the frame is dropped instead.
+    // Every presented frame consumes an index, so that skipped frames show up as gaps.
+    mimas_u64 const frame_index = capture->next_frame_index;
+    capture->next_frame_index += 1;
+    if(capture->pending == capture->slot_count) {
+        capture->dropped_frames += 1;
+        return;
+    }
+
+    _mimas_trace_begin("_mimas_gl_capture_frame");
+    mimas_i32 width = 0;
+    mimas_i32 height = 0;
+    mimas_platform_get_window_framebuffer_size(window, &width, &height);
+    if(width <= 0 || height <= 0) {
+        _mimas_trace_end("_mimas_gl_capture_frame");
+        return;
+    }
+
+    Mimas_GL_Capture_Procs const* const gl = &capture->gl;
+    mimas_i32 prev_pack_buffer = 0;
+    mimas_i32 prev_read_framebuffer = 0;
+    mimas_i32 prev_read_buffer = 0;
+    mimas_i32 prev_pack_alignment = 0;
+    gl->GetIntegerv(MIMAS_GL_PIXEL_PACK_BUFFER_BINDING, &prev_pack_buffer);
+    gl->GetIntegerv(MIMAS_GL_READ_FRAMEBUFFER_BINDING, &prev_read_framebuffer);
+    gl->GetIntegerv(MIMAS_GL_PACK_ALIGNMENT, &prev_pack_alignment);
+    gl->BindFramebuffer(MIMAS_GL_READ_FRAMEBUFFER, 0);
+    gl->GetIntegerv(MIMAS_GL_READ_BUFFER, &prev_read_buffer);
+
+    Mimas_GL_Capture_Slot* const slot = &capture->slots[capture->head];
+    mimas_u64 const size = (mimas_u64)width * (mimas_u64)height * 4;
+    gl->BindBuffer(MIMAS_GL_PIXEL_PACK_BUFFER, slot->buffer);
+    if(slot->size != size) {
+        gl->BufferData(MIMAS_GL_PIXEL_PACK_BUFFER, (ptrdiff_t)size, NULL, MIMAS_GL_STREAM_READ);
+        slot->size = size;
+    }
+    gl->ReadBuffer(MIMAS_GL_BACK);
+    gl->PixelStorei(MIMAS_GL_PACK_ALIGNMENT, 4);
+    gl->ReadPixels(0, 0, width, height, MIMAS_GL_RGBA, MIMAS_GL_UNSIGNED_BYTE, NULL);
+    slot->fence = gl->FenceSync(MIMAS_GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot->width = width;
+    slot->height = height;
+    slot->timestamp_ns = mimas_platform_get_time_ns();
+    slot->frame_index = frame_index;
+
+    gl->PixelStorei(MIMAS_GL_PACK_ALIGNMENT, prev_pack_alignment);
+    gl->ReadBuffer((mimas_u32)prev_read_buffer);
+    gl->BindFramebuffer(MIMAS_GL_READ_FRAMEBUFFER, (mimas_u32)prev_read_framebuffer);
+    gl->BindBuffer(MIMAS_GL_PIXEL_PACK_BUFFER, (mimas_u32)prev_pack_buffer);
+
+    capture->head = (capture->head + 1) % capture->slot_count;
+    capture->pending += 1;
+    _mimas_trace_end("_mimas_gl_capture_frame");
+}
+
+mimas_bool mimas_acquire_captured_frame(Mimas_Window* const window, Mimas_Captured_Frame* const frame) {
+    Mimas_GL_Capture* const capture = window->capture;
+    if(!capture || capture->frame_export || capture->pending == 0) {
+        return mimas_false;
+    }
+
+    Mimas_GL_Capture_Slot* const slot = &capture->slots[capture->tail];
+    Mimas_GL_Capture_Procs const* const gl = &capture->gl;
+    if(!is_slot_complete(capture, slot)) {
+        return mimas_false;
+    }
+
+    Mimas_GL_Captured_Frame_Storage* storage = NULL;
+    for(mimas_u32 i = 0; i < capture->slot_count; ++i) {
+        if(!_mimas_atomic_load_i32(&capture->frames[i].in_use)) {
+            storage = &capture->frames[i];
+            break;
+        }
+    }
+    if(!storage) {
+        // Every frame is still held by the user. Keep the slot so that it can be acquired once a frame is released.
+        return mimas_false;
+    }
+    // Pairs with the fence in mimas_release_captured_frame so that the user is done reading before we overwrite the pixels.
+    _mimas_atomic_fence();
+
+    _mimas_trace_begin("mimas_acquire_captured_frame");
+    if(storage->capacity < slot->size) {
+        _mimas_free(storage->pixels);
+        storage->pixels = _mimas_malloc(slot->size);
+        storage->capacity = slot->size;
+    }
+
+    mimas_i32 prev_pack_buffer = 0;
+    gl->GetIntegerv(MIMAS_GL_PIXEL_PACK_BUFFER_BINDING, &prev_pack_buffer);
+    gl->BindBuffer(MIMAS_GL_PIXEL_PACK_BUFFER, slot->buffer);
+    void const* const mapped = gl->MapBufferRange(MIMAS_GL_PIXEL_PACK_BUFFER, 0, (ptrdiff_t)slot->size, MIMAS_GL_MAP_READ_BIT);
+    mimas_bool const mapped_ok = mapped != NULL;
+    if(mapped_ok) {
+        memcpy(storage->pixels, mapped, slot->size);
+        gl->UnmapBuffer(MIMAS_GL_PIXEL_PACK_BUFFER);
+    }
+    gl->BindBuffer(MIMAS_GL_PIXEL_PACK_BUFFER, (mimas_u32)prev_pack_buffer);
+
+    retire_tail_slot(capture);
+    if(!mapped_ok) {
+        // TODO: Error
+        _mimas_trace_end("mimas_acquire_captured_frame");
+        return mimas_false;
+    }
+
+    _mimas_atomic_store_i32(&storage->in_use, mimas_true);
+    frame->pixels = storage->pixels;
+    frame->width = slot->width;
+    frame->height = slot->height;
+    frame->stride = slot->width * 4;
+    frame->timestamp_ns = slot->timestamp_ns;
+    frame->frame_index = slot->frame_index;
+    frame->handle = storage;
+    _mimas_trace_end("mimas_acquire_captured_frame");
+    return mimas_true;
+}
+
+void mimas_release_captured_frame(Mimas_Captured_Frame const* const frame) {
+    Mimas_GL_Captured_Frame_Storage* const storage = (Mimas_GL_Captured_Frame_Storage*)frame->handle;
+    _mimas_atomic_fence();
+    _mimas_atomic_store_i32(&storage->in_use, mimas_false);
+}
+
+mimas_bool mimas_set_capture_export(Mimas_Window* const window, Mimas_Frame_Export* const frame_export) {
+    if(!window->capture) {
+        // TODO: Error
+        return mimas_false;
+    }
+
+    window->capture->frame_export = frame_export;
+    return mimas_true;
+}
+
+mimas_u64 mimas_get_dropped_capture_frames(Mimas_Window* const window) {
+    return window->capture ? window->capture->dropped_frames : 0;
+}
@@ -0,0 +1,12 @@
+#ifndef MIMAS_GL_CAPTURE_H_INCLUDE
+#define MIMAS_GL_CAPTURE_H_INCLUDE
+
+#include <mimas/mimas_gl.h>
+#include <internal.h>
+
+// Queues the readback of the window's back buffer. Called by mimas_swap_buffers right before the buffers are swapped.
+void _mimas_gl_capture_frame(Mimas_Window* window);
+// Frees the capture state of a window that is being destroyed.
+void _mimas_gl_free_capture(Mimas_Window* window);
+
+#endif // !MIMAS_GL_CAPTURE_H_INCLUDE
@@ -0,0 +1,419 @@
+#include <platform.h>
+#include <internal.h>
+#include <instrument.h>
+#include <atomic.h>
+#include <utils.h>
+
+#include <string.h>
+
+// Backend without a display. Windows only exist in memory and never receive input,
+// which makes it suitable for running applications and their tests on machines without a window system.
+
+#define MIMAS_HEADLESS_MONITOR_WIDTH 1920
+#define MIMAS_HEADLESS_MONITOR_HEIGHT 1080
+
+#define _MIMAS_HEADLESS_DECLARE_PLATFORM_FUNCTION(return_type, function, parameters) return_type mimas_headless_platform_##function parameters;
+MIMAS_PLATFORM_FUNCTIONS(_MIMAS_HEADLESS_DECLARE_PLATFORM_FUNCTION)
+#undef _MIMAS_HEADLESS_DECLARE_PLATFORM_FUNCTION
+
+typedef struct Mimas_Headless_Key_Event {
+    struct Mimas_Headless_Key_Event* next;
+    Mimas_Key key;
+    Mimas_Key_Action action;
+    mimas_u64 timestamp_ns;
+} Mimas_Headless_Key_Event;
+
+typedef struct {
+    Mimas_Rect rect;
+    mimas_bool visible;
+    mimas_bool minimized;
+    mimas_bool maximized;
+    // Rect to go back to when the window is restored.
+    Mimas_Rect restore_rect;
+    // Rect to go back to when the window leaves fullscreen.
+    Mimas_Rect windowed_rect;
+    // Mimas_Headless_Key_Event list of the keys injected since the last poll, newest first. Pushed from any thread.
+    void* volatile injected_keys;
+} Mimas_Headless_Window;
+
+typedef struct {
+    mimas_i32 swap_interval;
+} Mimas_Headless_Platform;
+
+static void set_window_rect(Mimas_Window* const window, Mimas_Rect const rect) {
+    Mimas_Headless_Window* const native_window = (Mimas_Headless_Window*)window->native_window;
+    mimas_i32 const width = rect.right - rect.left;
+    mimas_i32 const height = rect.bottom - rect.top;
+    mimas_bool const resized = width != native_window->rect.right - native_window->rect.left || height != native_window->rect.bottom - native_window->rect.top;
+    native_window->rect = rect;
+    if(resized) {
+        _mimas_window_resized(window, width, height, width, height);
+    }
+}
+
+mimas_bool mimas_headless_platform_init(Mimas_Backend const backend) {
+    MIMAS_UNUSED(backend);
+    Mimas_Headless_Platform* const platform = (Mimas_Headless_Platform*)_mimas_malloc(sizeof(Mimas_Headless_Platform));
+    memset(platform, 0, sizeof(Mimas_Headless_Platform));
+    _mimas_get_mimas_internal()->platform = platform;
+    return mimas_true;
+}
+
+void mimas_headless_platform_terminate(Mimas_Backend const backend) {
+    MIMAS_UNUSED(backend);
+    Mimas_Internal* const _mimas = _mimas_get_mimas_internal();
+    _mimas_free(_mimas->platform);
+    _mimas->platform = NULL;
+}
+
+// Detaches the injected keys of the window and returns them oldest first.
+static Mimas_Headless_Key_Event* take_injected_keys(Mimas_Headless_Window* const native_window) {
+    void* head = _mimas_atomic_load_ptr(&native_window->injected_keys);
+    while(head && !_mimas_atomic_cas_ptr(&native_window->injected_keys, head, NULL)) {
+        head = _mimas_atomic_load_ptr(&native_window->injected_keys);
+    }
+
+    Mimas_Headless_Key_Event* reversed = NULL;
+    for(Mimas_Headless_Key_Event* event = (Mimas_Headless_Key_Event*)head; event;) {
+        Mimas_Headless_Key_Event* const next = event->next;
+        event->next = reversed;
+        reversed = event;
+        event = next;
+    }
+    return reversed;
+}
+
+mimas_u32 mimas_headless_platform_poll_events(void) {
+    // Injected keys are the only events a headless window ever receives.
+    mimas_u32 events = 0;
+    for(Mimas_Window* window = _mimas_get_mimas_internal()->windows; window; window = window->next) {
+        Mimas_Headless_Key_Event* event = take_injected_keys((Mimas_Headless_Window*)window->native_window);
+        while(event) {
+            _mimas_stats_count_window_event(window);
+            if(window->event_mask & MIMAS_EVENT_MASK_KEY) {
+                window->keys[event->key] = event->action;
+                _mimas_stats_count_input(window, event->timestamp_ns);
+                if(window->callbacks.key) {
+                    _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_KEY, window->callbacks.key(window, event->key, event->action, window->callbacks.key_data));
+                }
+            }
+
+            Mimas_Headless_Key_Event* const next = event->next;
+            _mimas_free(event);
+            event = next;
+            events += 1;
+        }
+    }
+    return events;
+}
+
+void mimas_headless_platform_wait_events(mimas_u32 const timeout_ms) {
+    MIMAS_UNUSED(timeout_ms);
+    // No events ever arrive, therefore waiting would only stall the caller.
+}
+
+void mimas_headless_platform_post_empty_event(void) {}
+
+void* mimas_headless_platform_get_event_handle(void) {
+    return NULL;
+}
+
+Mimas_Window* mimas_headless_platform_create_window(Mimas_Window_Create_Info const info) {
+    Mimas_Window* const window = (Mimas_Window*)_mimas_malloc(sizeof(Mimas_Window));
+    memset(window, 0, sizeof(Mimas_Window));
+    Mimas_Headless_Window* const native_window = (Mimas_Headless_Window*)_mimas_malloc(sizeof(Mimas_Headless_Window));
+    memset(native_window, 0, sizeof(Mimas_Headless_Window));
+    native_window->rect = (Mimas_Rect){.left = 0, .top = 0, .right = info.width, .bottom = info.height};
+    window->native_window = native_window;
+    window->decorated = info.decorated;
+    window->content_scale = 1.0f;
+    return window;
+}
+
+void mimas_headless_platform_set_window_pool_size(mimas_u32 const size) {
+    MIMAS_UNUSED(size);
+}
+
+void mimas_headless_platform_destroy_window(Mimas_Window* const window) {
+    for(Mimas_Headless_Key_Event* event = take_injected_keys((Mimas_Headless_Window*)window->native_window); event;) {
+        Mimas_Headless_Key_Event* const next = event->next;
+        _mimas_free(event);
+        event = next;
+    }
+    _mimas_free(window->native_window);
+    _mimas_free(window);
+}
+
+// Headless windows have no frame, therefore the window and the content rects are the same.
+void mimas_headless_platform_get_window_pos(Mimas_Window* const window, mimas_i32* const x, mimas_i32* const y) {
+    Mimas_Headless_Window* const native_window = (Mimas_Headless_Window*)window->native_window;
+    *x = native_window->rect.left;
+    *y = native_window->rect.top;
+}
+
+void mimas_headless_platform_get_window_content_pos(Mimas_Window* const window, mimas_i32* const x, mimas_i32* const y) {
+    mimas_headless_platform_get_window_pos(window, x, y);
+}
+
+void mimas_headless_platform_get_window_content_size(Mimas_Window* const window, mimas_i32* const width, mimas_i32* const height) {
+    Mimas_Headless_Window* const native_window = (Mimas_Headless_Window*)window->native_window;
+    *width = native_window->rect.right - native_window->rect.left;
+    *height = native_window->rect.bottom - native_window->rect.top;
+}
+
+void mimas_headless_platform_get_window_framebuffer_size(Mimas_Window* const window, mimas_i32* const width, mimas_i32* const height) {
+    mimas_headless_platform_get_window_content_size(window, width, height);
+}
+
+static void update_window_visibility(Mimas_Window* const window) {
+    Mimas_Headless_Window* const native_window = (Mimas_Headless_Window*)window->native_window;
+    if(!native_window->visible) {
+        _mimas_window_visibility_changed(window, MIMAS_WINDOW_HIDDEN);
+    } else if(native_window->minimized) {
+        _mimas_window_visibility_changed(window, MIMAS_WINDOW_MINIMIZED);
+    } else {
+        _mimas_window_visibility_changed(window, MIMAS_WINDOW_VISIBLE);
+    }
+}
+
+void mimas_headless_platform_apply_window_updates(Mimas_Window* const* const windows, mimas_u32 const count) {
+    for(mimas_u32 i = 0; i < count; ++i) {
+        Mimas_Window* const window = windows[i];
+        Mimas_Headless_Window* const native_window = (Mimas_Headless_Window*)window->native_window;
+        mimas_u32 const update = window->update.flags;
+        Mimas_Rect rect = native_window->rect;
+        if(update & (MIMAS_WINDOW_UPDATE_POS | MIMAS_WINDOW_UPDATE_CONTENT_POS)) {
+            rect.right += window->update.x - rect.left;
+            rect.bottom += window->update.y - rect.top;
+            rect.left = window->update.x;
+            rect.top = window->update.y;
+        }
+        if(update & MIMAS_WINDOW_UPDATE_CONTENT_SIZE) {
+            rect.right = rect.left + window->update.width;
+            rect.bottom = rect.top + window->update.height;
+        }
+        if(update & MIMAS_WINDOW_UPDATE_VISIBLE) {
+            native_window->visible = window->update.visible;
+        }
+        if(update & MIMAS_WINDOW_UPDATE_DECORATED) {
+            window->decorated = window->update.decorated;
+        }
+        set_window_rect(window, rect);
+        update_window_visibility(window);
+    }
+}
+
+void mimas_headless_platform_restore_window(Mimas_Window* const window) {
+    Mimas_Headless_Window* const native_window = (Mimas_Headless_Window*)window->native_window;
+    if(native_window->maximized) {
+        set_window_rect(window, native_window->restore_rect);
+    }
+    native_window->visible = mimas_true;
+    native_window->minimized = mimas_false;
+    native_window->maximized = mimas_false;
+    update_window_visibility(window);
+}
+
+void mimas_headless_platform_minimize_window(Mimas_Window* const window) {
+    Mimas_Headless_Window* const native_window = (Mimas_Headless_Window*)window->native_window;
+    native_window->minimized = mimas_true;
+    update_window_visibility(window);
+}
+
+void mimas_headless_platform_maximize_window(Mimas_Window* const window) {
+    Mimas_Headless_Window* const native_window = (Mimas_Headless_Window*)window->native_window;
+    if(!native_window->maximized) {
+        native_window->restore_rect = native_window->rect;
+    }
+    native_window->visible = mimas_true;
+    native_window->minimized = mimas_false;
+    native_window->maximized = mimas_true;
+    update_window_visibility(window);
+    set_window_rect(window, (Mimas_Rect){.left = 0, .top = 0, .right = MIMAS_HEADLESS_MONITOR_WIDTH, .bottom = MIMAS_HEADLESS_MONITOR_HEIGHT});
+}
+
+mimas_bool mimas_headless_platform_set_window_fullscreen(Mimas_Window* const window, Mimas_Fullscreen_Mode const mode, mimas_u32 const monitor_index, Mimas_Video_Mode const* const video_mode) {
+    Mimas_Headless_Window* const native_window = (Mimas_Headless_Window*)window->native_window;
+    if(mode == MIMAS_WINDOWED) {
+        if(window->fullscreen != MIMAS_WINDOWED) {
+            window->fullscreen = MIMAS_WINDOWED;
+            set_window_rect(window, native_window->windowed_rect);
+        }
+        return mimas_true;
+    }
+
+    if(monitor_index != 0) {
+        return mimas_false;
+    }
+
+    if(window->fullscreen == MIMAS_WINDOWED) {
+        native_window->windowed_rect = native_window->rect;
+    }
+
+    window->fullscreen = mode;
+    // The virtual monitor takes on any video mode.
+    if(mode == MIMAS_FULLSCREEN_EXCLUSIVE && video_mode) {
+        set_window_rect(window, (Mimas_Rect){.left = 0, .top = 0, .right = video_mode->width, .bottom = video_mode->height});
+    } else {
+        set_window_rect(window, (Mimas_Rect){.left = 0, .top = 0, .right = MIMAS_HEADLESS_MONITOR_WIDTH, .bottom = MIMAS_HEADLESS_MONITOR_HEIGHT});
+    }
+    return mimas_true;
+}
+
+void mimas_headless_platform_swap_buffers(Mimas_Window* const window) {
+    MIMAS_UNUSED(window);
+}
+
+void mimas_headless_platform_set_swap_interval(mimas_i32 const interval) {
+    Mimas_Headless_Platform* const platform = (Mimas_Headless_Platform*)_mimas_get_mimas_internal()->platform;
+    platform->swap_interval = interval;
+}
+
+mimas_i32 mimas_headless_platform_get_swap_interval(void) {
+    Mimas_Headless_Platform* const platform = (Mimas_Headless_Platform*)_mimas_get_mimas_internal()->platform;
+    return platform->swap_interval;
+}
+
+void mimas_headless_platform_inject_key(Mimas_Window* const window, Mimas_Key const key, Mimas_Key_Action const action, mimas_u64 const timestamp_ns) {
+    Mimas_Headless_Window* const native_window = (Mimas_Headless_Window*)window->native_window;
+    Mimas_Headless_Key_Event* const event = (Mimas_Headless_Key_Event*)_mimas_malloc(sizeof(Mimas_Headless_Key_Event));
+    event->key = key;
+    event->action = action;
+    event->timestamp_ns = timestamp_ns;
+    do {
+        event->next = (Mimas_Headless_Key_Event*)_mimas_atomic_load_ptr(&native_window->injected_keys);
+    } while(!_mimas_atomic_cas_ptr(&native_window->injected_keys, event->next, event));
+}
+
+void mimas_headless_platform_set_cursor_mode(Mimas_Window* const window, Mimas_Cursor_Mode const cursor_mode) {
+    window->cursor_mode = cursor_mode;
+}
+
+void mimas_headless_platform_get_cursor_pos(mimas_i32* const x, mimas_i32* const y) {
+    *x = 0;
+    *y = 0;
+}
+
+Mimas_Mouse_Button_Action mimas_headless_platform_get_mouse_button(Mimas_Mouse_Button const button) {
+    MIMAS_UNUSED(button);
+    return MIMAS_MOUSE_BUTTON_RELEASE;
+}
+
+// A single virtual monitor so that applications can lay out their windows.
+mimas_u32 mimas_headless_platform_get_monitors(Mimas_Monitor* const monitors, mimas_u32 const capacity) {
+    if(monitors && capacity > 0) {
+        memset(monitors, 0, sizeof(Mimas_Monitor));
+        strcpy(monitors->name, "headless");
+        monitors->rect = (Mimas_Rect){.left = 0, .top = 0, .right = MIMAS_HEADLESS_MONITOR_WIDTH, .bottom = MIMAS_HEADLESS_MONITOR_HEIGHT};
+        monitors->work_rect = monitors->rect;
+        monitors->content_scale = 1.0f;
+        monitors->refresh_rate_numerator = 60;
+        monitors->refresh_rate_denominator = 1;
+        monitors->primary = mimas_true;
+    }
+    return 1;
+}
+
+mimas_bool mimas_headless_platform_get_frame_timing(Mimas_Window* const window, mimas_u64* const vblank_ns, mimas_u64* const period_ns) {
+    MIMAS_UNUSED(window);
+    // The virtual monitor refreshes at 60 Hz starting at time 0.
+    *vblank_ns = 0;
+    *period_ns = 1000000000ULL / 60;
+    return mimas_true;
+}
+
+Mimas_Screen_Capture* mimas_headless_platform_create_screen_capture(mimas_u32 const monitor_index) {
+    MIMAS_UNUSED(monitor_index);
+    // The virtual monitor has no contents to capture.
+    return NULL;
+}
+
+void mimas_headless_platform_destroy_screen_capture(Mimas_Screen_Capture* const capture) {
+    MIMAS_UNUSED(capture);
+}
+
+mimas_bool mimas_headless_platform_capture_screen(Mimas_Screen_Capture* const capture, mimas_u32 const timeout_ms, Mimas_Screen_Frame* const frame) {
+    MIMAS_UNUSED(capture);
+    MIMAS_UNUSED(timeout_ms);
+    MIMAS_UNUSED(frame);
+    return mimas_false;
+}
+
+mimas_bool mimas_headless_platform_update_monitors(void) {
+    return mimas_false;
+}
+
+mimas_bool mimas_headless_platform_set_clipboard(Mimas_Clipboard_Offer const offer) {
+    MIMAS_UNUSED(offer);
+    return mimas_false;
+}
+
+void mimas_headless_platform_write_clipboard_data(Mimas_Clipboard_Sink* const sink, void const* const data, mimas_u64 const size) {
+    MIMAS_UNUSED(sink);
+    MIMAS_UNUSED(data);
+    MIMAS_UNUSED(size);
+}
+
+mimas_bool mimas_headless_platform_get_clipboard(char const* const mime_type, mimas_clipboard_receive_callback const callback, void* const user_data) {
+    MIMAS_UNUSED(mime_type);
+    MIMAS_UNUSED(callback);
+    MIMAS_UNUSED(user_data);
+    return mimas_false;
+}
+
+mimas_bool mimas_headless_platform_has_clipboard_data(char const* const mime_type) {
+    MIMAS_UNUSED(mime_type);
+    return mimas_false;
+}
+
+mimas_bool mimas_headless_platform_set_gamepad_input_enabled(mimas_bool const enabled) {
+    return !enabled;
+}
+
+mimas_bool mimas_headless_platform_get_gamepad_state(mimas_u32 const index, Mimas_Gamepad_State* const state) {
+    MIMAS_UNUSED(index);
+    memset(state, 0, sizeof(Mimas_Gamepad_State));
+    return mimas_false;
+}
+
+mimas_bool mimas_headless_platform_create_gl_context(Mimas_GL_Context* const ctx, Mimas_GL_Context_Create_Info const* const info) {
+    MIMAS_UNUSED(ctx);
+    MIMAS_UNUSED(info);
+    // Headless windows have no framebuffer that a context could render to.
+    return mimas_false;
+}
+
+void mimas_headless_platform_destroy_gl_context(Mimas_GL_Context* const ctx) {
+    MIMAS_UNUSED(ctx);
+}
+
+mimas_bool mimas_headless_platform_make_context_current(Mimas_Window* const window, Mimas_GL_Context* const ctx) {
+    MIMAS_UNUSED(window);
+    MIMAS_UNUSED(ctx);
+    return mimas_false;
+}
+
+Mimas_GL_Proc mimas_headless_platform_get_gl_proc_address(char const* const name) {
+    MIMAS_UNUSED(name);
+    return NULL;
+}
+
+char const** mimas_headless_platform_get_vk_extensions(void) {
+    static char const* vk_headless_extensions[] = {NULL};
+    return vk_headless_extensions;
+}
+
+VkResult mimas_headless_platform_create_vk_surface(Mimas_Window* const window, VkInstance const instance, struct VkAllocationCallbacks const* const allocation_callbacks, VkSurfaceKHR* const surface) {
+    MIMAS_UNUSED(window);
+    MIMAS_UNUSED(instance);
+    MIMAS_UNUSED(allocation_callbacks);
+    MIMAS_UNUSED(surface);
+    return VK_ERROR_INITIALIZATION_FAILED;
+}
+
+#define _MIMAS_HEADLESS_PLATFORM_VTABLE_ENTRY(return_type, function, parameters) .function = mimas_headless_platform_##function,
+
+Mimas_Platform_Vtable const mimas_headless_platform_vtable = {
+    .name = "headless",
+    MIMAS_PLATFORM_FUNCTIONS(_MIMAS_HEADLESS_PLATFORM_VTABLE_ENTRY)
+};
@@ -0,0 +1,20 @@
+#ifndef MIMAS_INSTRUMENT_H_INCLUDE
+#define MIMAS_INSTRUMENT_H_INCLUDE
+
+#include <mimas/mimas.h>
+#include <stats.h>
+#include <trace.h>
+
+extern char const* const _mimas_callback_names[MIMAS_CALLBACK_TYPE_COUNT];
+
+// Invoke a user callback, trace it and measure the time spent in it.
+#define _MIMAS_INVOKE_CALLBACK(window, type, invocation)                   \
+    do {                                                                   \
+        _mimas_trace_begin(_mimas_callback_names[type]);                   \
+        mimas_u64 const _mimas_callback_start = _mimas_stats_begin();      \
+        invocation;                                                        \
+        _mimas_stats_end_callback(window, type, _mimas_callback_start);    \
+        _mimas_trace_end(_mimas_callback_names[type]);                     \
+    } while(0)
+
+#endif // !MIMAS_INSTRUMENT_H_INCLUDE
@@ -1,5 +1,8 @@
 #include <mimas/mimas.h>
 #include <internal.h>
+#include <instrument.h>
+#include <platform.h>
+#include <atomic.h>
 
 #include <stdlib.h>
 #include <string.h>
@@ -7,13 +10,14 @@
 static Mimas_Internal* _mimas = NULL;
 
 void _mimas_init_internal(Mimas_Backend const backend) {
-    _mimas = (Mimas_Internal*)malloc(sizeof(Mimas_Internal));
+    _mimas = (Mimas_Internal*)_mimas_malloc(sizeof(Mimas_Internal));
     memset(_mimas, 0, sizeof(Mimas_Internal));
     _mimas->backend = backend;
 }
 
 void _mimas_terminate_internal() {
-    free(_mimas);
+    _mimas_free(_mimas);
+    _mimas = NULL;
 }
 
 mimas_bool _mimas_is_initialized() {
@@ -23,3 +27,273 @@ mimas_bool _mimas_is_initialized() {
 Mimas_Internal* _mimas_get_mimas_internal() {
     return _mimas;
 }
+
+// Serial of the last registered window. Windows may be created on any thread.
+static mimas_u64 volatile last_window_serial = 0;
+
+void _mimas_register_window(Mimas_Window* const window) {
+    window->serial = _mimas_atomic_add_u64(&last_window_serial, 1);
+    // Windows do not process events before they are handed to the user, e.g. while they wait in the pool.
+    window->event_mask = MIMAS_EVENT_MASK_ALL;
+    window->next = _mimas->windows;
+    _mimas->windows = window;
+}
+
+void _mimas_unregister_window(Mimas_Window* const window) {
+    Mimas_Window** link = &_mimas->windows;
+    while(*link && *link != window) {
+        link = &(*link)->next;
+    }
+
+    if(*link) {
+        *link = window->next;
+    }
+
+    if(_mimas->active_window == window) {
+        _mimas->active_window = NULL;
+    }
+}
+
+void _mimas_append_text_input(Mimas_Window* const window, mimas_u32 const codepoint) {
+    if(!window->callbacks.text || !(window->event_mask & MIMAS_EVENT_MASK_TEXT)) {
+        return;
+    }
+
+    _mimas_stats_count_input(window, 0);
+
+    char encoded[4];
+    mimas_u32 length;
+    if(codepoint < 0x80) {
+        encoded[0] = (char)codepoint;
+        length = 1;
+    } else if(codepoint < 0x800) {
+        encoded[0] = (char)(0xC0 | (codepoint >> 6));
+        encoded[1] = (char)(0x80 | (codepoint & 0x3F));
+        length = 2;
+    } else if(codepoint < 0x10000) {
+        encoded[0] = (char)(0xE0 | (codepoint >> 12));
+        encoded[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        encoded[2] = (char)(0x80 | (codepoint & 0x3F));
+        length = 3;
+    } else if(codepoint < 0x110000) {
+        encoded[0] = (char)(0xF0 | (codepoint >> 18));
+        encoded[1] = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+        encoded[2] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        encoded[3] = (char)(0x80 | (codepoint & 0x3F));
+        length = 4;
+    } else {
+        return;
+    }
+
+    if(window->text_input.size + length > window->text_input.capacity) {
+        mimas_u32 const capacity = window->text_input.capacity ? window->text_input.capacity * 2 : 64;
+        char* const data = (char*)_mimas_realloc(window->text_input.data, capacity);
+        if(!data) {
+            return;
+        }
+        window->text_input.data = data;
+        window->text_input.capacity = capacity;
+    }
+
+    memcpy(window->text_input.data + window->text_input.size, encoded, length);
+    window->text_input.size += length;
+}
+
+void _mimas_window_resized(Mimas_Window* const window, mimas_i32 const width, mimas_i32 const height, mimas_i32 const framebuffer_width, mimas_i32 const framebuffer_height) {
+    window->resize.width = width;
+    window->resize.height = height;
+    window->resize.framebuffer_width = framebuffer_width;
+    window->resize.framebuffer_height = framebuffer_height;
+    window->resize.pending = mimas_true;
+}
+
+void _mimas_dispatch_resize(Mimas_Window* const window) {
+    if(!window->resize.pending) {
+        return;
+    }
+
+    window->resize.pending = mimas_false;
+    if(window->callbacks.resize && (window->event_mask & MIMAS_EVENT_MASK_RESIZE)) {
+        _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_RESIZE, window->callbacks.resize(window, window->resize.width, window->resize.height, window->resize.framebuffer_width, window->resize.framebuffer_height, window->callbacks.resize_data));
+    }
+}
+
+void _mimas_window_visibility_changed(Mimas_Window* const window, Mimas_Window_Visibility const visibility) {
+    _mimas_atomic_store_i32(&window->visibility.state, (mimas_i32)visibility);
+}
+
+static void dispatch_visibility(Mimas_Window* const window) {
+    Mimas_Window_Visibility const state = (Mimas_Window_Visibility)_mimas_atomic_load_i32(&window->visibility.state);
+    if(window->visibility.reported == state) {
+        return;
+    }
+
+    window->visibility.reported = state;
+    if(window->callbacks.visibility && (window->event_mask & MIMAS_EVENT_MASK_VISIBILITY)) {
+        _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_VISIBILITY, window->callbacks.visibility(window, state, window->callbacks.visibility_data));
+    }
+}
+
+static void dispatch_text_input(Mimas_Window* const window) {
+    if(window->text_input.size == 0) {
+        return;
+    }
+
+    // Reset the size before invoking the callback in case the callback pumps events.
+    mimas_u32 const size = window->text_input.size;
+    window->text_input.size = 0;
+    if(window->callbacks.text) {
+        _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_TEXT, window->callbacks.text(window, window->text_input.data, size, window->callbacks.text_data));
+    }
+}
+
+typedef struct {
+    mimas_bool queried;
+    mimas_u64 vblank_ns;
+    mimas_u64 period_ns;
+} Mimas_Frame_Timing;
+
+static mimas_bool is_redraw_pending(Mimas_Window* const window) {
+    // Hidden and minimized windows are not presented, so we hold their requests until they are shown again.
+    Mimas_Window_Visibility const state = (Mimas_Window_Visibility)_mimas_atomic_load_i32(&window->visibility.state);
+    return _mimas_atomic_load_u64(&window->redraw.requested) && window->callbacks.redraw && (window->event_mask & MIMAS_EVENT_MASK_REDRAW) &&
+           state != MIMAS_WINDOW_HIDDEN && state != MIMAS_WINDOW_MINIMIZED;
+}
+
+// Returns the start of the first refresh interval after the one of the last redraw of window.
+static mimas_u64 get_next_redraw_time(Mimas_Window* const window, Mimas_Frame_Timing* const timing) {
+    if(window->redraw.last_ns == 0) {
+        return 0;
+    }
+
+    // All windows are redrawn on the same clock, therefore we query it at most once per dispatch.
+    if(!timing->queried) {
+        timing->queried = mimas_true;
+        if(!mimas_platform_get_frame_timing(window, &timing->vblank_ns, &timing->period_ns) || timing->period_ns == 0) {
+            timing->vblank_ns = 0;
+            timing->period_ns = 1000000000ULL / 60;
+        }
+    }
+
+    mimas_u64 const phase = timing->vblank_ns % timing->period_ns;
+    mimas_u64 const last = window->redraw.last_ns;
+    if(last < phase) {
+        return phase;
+    }
+    return phase + ((last - phase) / timing->period_ns + 1) * timing->period_ns;
+}
+
+static void dispatch_redraw(Mimas_Window* const window, Mimas_Frame_Timing* const timing, mimas_u64 const now) {
+    if(!is_redraw_pending(window) || get_next_redraw_time(window, timing) > now) {
+        return;
+    }
+
+    // Clear the request before invoking the callback so that requests made during the redraw schedule another one.
+    _mimas_atomic_store_u64(&window->redraw.requested, 0);
+    window->redraw.last_ns = now;
+    _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_REDRAW, window->callbacks.redraw(window, window->callbacks.redraw_data));
+}
+
+mimas_u32 _mimas_get_redraw_wait_timeout(mimas_u32 const timeout_ms) {
+    mimas_u32 timeout = timeout_ms;
+    Mimas_Frame_Timing timing = {0};
+    mimas_u64 const now = mimas_platform_get_time_ns();
+    for(Mimas_Window* window = _mimas->windows; window; window = window->next) {
+        if(!is_redraw_pending(window)) {
+            continue;
+        }
+
+        mimas_u64 const next = get_next_redraw_time(window, &timing);
+        if(next <= now) {
+            return 0;
+        }
+
+        // Round up, otherwise we would wake up just before the next refresh and spin until it starts.
+        mimas_u64 const wait_ms = (next - now + 999999) / 1000000;
+        if(timeout == MIMAS_WAIT_FOREVER || wait_ms < timeout) {
+            timeout = (mimas_u32)wait_ms;
+        }
+    }
+    return timeout;
+}
+
+void _mimas_commit_window_updates(Mimas_Window* const* const windows, mimas_u32 const count) {
+    mimas_platform_apply_window_updates(windows, count);
+    for(mimas_u32 i = 0; i < count; ++i) {
+        Mimas_Window* const window = windows[i];
+        _mimas_free(window->update.title);
+        window->update.title = NULL;
+        window->update.flags = 0;
+        window->update.in_transaction = mimas_false;
+    }
+}
+
+void _mimas_dispatch_coalesced_events() {
+    if(_mimas->monitors_changed && mimas_platform_update_monitors()) {
+        _mimas_trace_begin("monitors_changed_callback");
+        _mimas->monitors_changed(_mimas->monitors_changed_data);
+        _mimas_trace_end("monitors_changed_callback");
+    }
+
+    Mimas_Frame_Timing timing = {0};
+    mimas_u64 const now = mimas_platform_get_time_ns();
+    for(Mimas_Window* window = _mimas->windows; window; window = window->next) {
+        dispatch_visibility(window);
+        _mimas_dispatch_resize(window);
+        dispatch_text_input(window);
+        // Last, so that the redraw sees the state changes reported by the other callbacks.
+        dispatch_redraw(window, &timing, now);
+    }
+}
+
+void _mimas_begin_dispatch() {
+    _mimas->dispatch_depth += 1;
+}
+
+void _mimas_end_dispatch() {
+    _mimas->dispatch_depth -= 1;
+    if(_mimas->dispatch_depth > 0) {
+        return;
+    }
+
+    Mimas_Window* window = _mimas->windows;
+    while(window) {
+        Mimas_Window* const next = window->next;
+        if(window->destroy_pending) {
+            mimas_destroy_window(window);
+        }
+        window = next;
+    }
+}
+
+mimas_bool _mimas_defer_window_destruction(Mimas_Window* const window) {
+    // The dispatch still uses the window after the callback returns, e.g. to record statistics or to reach the next window.
+    if(_mimas->dispatch_depth == 0) {
+        return mimas_false;
+    }
+
+    window->destroy_pending = mimas_true;
+    window->event_mask = 0;
+    memset(&window->callbacks, 0, sizeof(window->callbacks));
+    return mimas_true;
+}
+
+void* _mimas_malloc(size_t const size) {
+    _mimas_stats_count_allocation();
+    return malloc(size);
+}
+
+void* _mimas_realloc(void* const ptr, size_t const size) {
+    _mimas_stats_count_allocation();
+    if(ptr) {
+        _mimas_stats_count_deallocation();
+    }
+    return realloc(ptr, size);
+}
+
+void _mimas_free(void* const ptr) {
+    if(ptr) {
+        _mimas_stats_count_deallocation();
+    }
+    free(ptr);
+}
@@ -3,6 +3,8 @@
 
 #include <mimas/mimas.h>
 
+#include <stddef.h>
+
 typedef enum Mimas_Backend {
     MIMAS_BACKEND_GL,
     MIMAS_BACKEND_VK,
@@ -12,6 +14,12 @@ typedef struct Mimas_Internal {
     void* platform;
     Mimas_Backend backend;
     Mimas_Window* active_window;
+    // Linked list of all windows created by the user.
+    Mimas_Window* windows;
+    mimas_monitors_changed_callback monitors_changed;
+    void* monitors_changed_data;
+    // Nesting depth of mimas_dispatch_pending. Windows destroyed by callbacks are freed when it drops to 0.
+    mimas_u32 dispatch_depth;
 } Mimas_Internal;
 
 void _mimas_init_internal(Mimas_Backend);
@@ -19,13 +27,62 @@ void _mimas_terminate_internal();
 mimas_bool _mimas_is_initialized();
 Mimas_Internal* _mimas_get_mimas_internal();
 
-// typedef in mimas/mimas.h
+void _mimas_register_window(Mimas_Window*);
+void _mimas_unregister_window(Mimas_Window*);
+
+// Appends a unicode codepoint to the window's text input if the window has a text callback.
+void _mimas_append_text_input(Mimas_Window*, mimas_u32 codepoint);
+// Records the new size of the window. The size is reported by the next dispatch.
+void _mimas_window_resized(Mimas_Window*, mimas_i32 width, mimas_i32 height, mimas_i32 framebuffer_width, mimas_i32 framebuffer_height);
+// Invokes the resize callback if the window has a pending resize.
+void _mimas_dispatch_resize(Mimas_Window*);
+// Records the new visibility of the window. The change is reported by the next dispatch.
+void _mimas_window_visibility_changed(Mimas_Window*, Mimas_Window_Visibility);
+// Invokes the callbacks of the events that have been coalesced during the poll.
+void _mimas_dispatch_coalesced_events();
+// Bracket the dispatch of events. Windows destroyed in between are freed by the outermost _mimas_end_dispatch.
+void _mimas_begin_dispatch();
+void _mimas_end_dispatch();
+// Returns mimas_true if the window cannot be freed yet because events are being dispatched.
+// The window stops receiving callbacks and is freed by _mimas_end_dispatch.
+mimas_bool _mimas_defer_window_destruction(Mimas_Window*);
+// Shortens timeout_ms so that a wait ends when the earliest pending redraw becomes due.
+mimas_u32 _mimas_get_redraw_wait_timeout(mimas_u32 timeout_ms);
+
+// Applies and clears the recorded property changes of windows and ends their transactions.
+void _mimas_commit_window_updates(Mimas_Window* const* windows, mimas_u32 count);
+
+// Allocation functions that all of mimas' allocations should go through.
+void* _mimas_malloc(size_t size);
+void* _mimas_realloc(void* ptr, size_t size);
+void _mimas_free(void* ptr);
+
+typedef struct Mimas_GL_Capture Mimas_GL_Capture;
+
+typedef enum {
+    MIMAS_WINDOW_UPDATE_POS = 1 << 0,
+    MIMAS_WINDOW_UPDATE_CONTENT_POS = 1 << 1,
+    MIMAS_WINDOW_UPDATE_CONTENT_SIZE = 1 << 2,
+    MIMAS_WINDOW_UPDATE_VISIBLE = 1 << 3,
+    MIMAS_WINDOW_UPDATE_TITLE = 1 << 4,
+    MIMAS_WINDOW_UPDATE_DECORATED = 1 << 5,
+} Mimas_Window_Update_Flags;
+
 struct Mimas_Window {
     mimas_bool decorated;
     mimas_bool close_requested;
+    Mimas_Fullscreen_Mode fullscreen;
     Mimas_Cursor_Mode cursor_mode;
+    // Mimas_Event_Mask of the events the window processes.
+    mimas_u32 event_mask;
     void* native_window;
     Mimas_Key_Action keys[256];
+    Mimas_Window* next;
+    // Unique for the lifetime of the process, unlike the address of the window.
+    // Identifies the window in thread-local state that may outlive it.
+    mimas_u64 serial;
+    // Destroyed by a callback. Freed once the dispatch that invoked the callback has finished.
+    mimas_bool destroy_pending;
 
     struct {
         mimas_window_activate_callback window_activate;
@@ -37,7 +94,76 @@ struct Mimas_Window {
         mimas_window_key_callback key;
         void* key_data;
         mimas_window_hittest hittest;
+        mimas_window_text_callback text;
+        void* text_data;
+        mimas_window_resize_callback resize;
+        void* resize_data;
+        mimas_window_content_scale_callback content_scale;
+        void* content_scale_data;
+        mimas_window_visibility_callback visibility;
+        void* visibility_data;
+        mimas_window_redraw_callback redraw;
+        void* redraw_data;
     } callbacks;
+
+    float content_scale;
+
+    struct {
+        mimas_i32 width;
+        mimas_i32 height;
+        mimas_i32 framebuffer_width;
+        mimas_i32 framebuffer_height;
+        mimas_bool pending;
+        // Minimum time between resize callbacks during interactive resizing.
+        mimas_u32 interval_ms;
+    } resize;
+
+    struct {
+        // Mimas_Window_Visibility. Written by the thread that owns the window and read by mimas_swap_buffers on the render thread.
+        mimas_i32 volatile state;
+        // Last state passed to the callback. Changes that revert before the dispatch are not reported.
+        Mimas_Window_Visibility reported;
+        // Time mimas_swap_buffers sleeps instead of presenting while the window is not visible. 0 if disabled.
+        mimas_i32 volatile throttle_interval_ms;
+    } visibility;
+
+    struct {
+        // Set by mimas_request_redraw on any thread and cleared before the callback is invoked.
+        mimas_u64 volatile requested;
+        // Time of the last invocation of the redraw callback. 0 if the callback has not been invoked yet.
+        mimas_u64 last_ns;
+    } redraw;
+
+    // Property changes recorded by the setters. Applied immediately unless a transaction is in progress.
+    struct {
+        mimas_bool in_transaction;
+        // Mimas_Window_Update_Flags of the recorded changes.
+        mimas_u32 flags;
+        // Position of the window if MIMAS_WINDOW_UPDATE_POS is set, of the content if MIMAS_WINDOW_UPDATE_CONTENT_POS is set.
+        mimas_i32 x;
+        mimas_i32 y;
+        mimas_i32 width;
+        mimas_i32 height;
+        mimas_bool visible;
+        mimas_bool decorated;
+        char* title;
+    } update;
+
+    // UTF-8 text input accumulated during the current poll.
+    struct {
+        char* data;
+        mimas_u32 size;
+        mimas_u32 capacity;
+    } text_input;
+
+    // Readback state of mimas_begin_capture. NULL if the window is not being captured.
+    Mimas_GL_Capture* capture;
+
+    // Events dispatched to the window during the current poll.
+    mimas_u64 poll_events;
+    // Time of the oldest input event that has not been presented yet. 0 if there is none. Cleared by mimas_swap_buffers on any thread.
+    mimas_u64 volatile unpresented_input_ns;
+    Mimas_Stats stats;
 };
 
 #endif // !MIMAS_MIMAS_INTERNAL_H_INCLUDE
@@ -3,24 +3,86 @@
 #include <platform.h>
 #include <platform_gl.h>
 #include <platform_vk.h>
+#include <gl_capture.h>
+#include <instrument.h>
+#include <atomic.h>
 
 #include <stdlib.h>
+#include <string.h>
 
 void mimas_terminate() {
     Mimas_Internal* const _mimas = _mimas_get_mimas_internal();
-    mimas_platform_terminate(_mimas->backend);
+    _mimas_terminate_platform(_mimas->backend);
     _mimas_terminate_internal();
 }
 
 void mimas_poll_events() {
-    mimas_platform_poll_events();
+    mimas_dispatch_pending();
+}
+
+mimas_u32 mimas_dispatch_pending() {
+    _mimas_trace_begin("mimas_poll_events");
+    mimas_u64 const start = _mimas_stats_begin();
+    _mimas_begin_dispatch();
+    mimas_u32 const events = mimas_platform_poll_events();
+    _mimas_dispatch_coalesced_events();
+    _mimas_end_dispatch();
+    _mimas_stats_end_poll(start, events);
+    _mimas_trace_end("mimas_poll_events");
+    return events;
+}
+
+void mimas_wait_events(mimas_u32 const timeout_ms) {
+    _mimas_trace_begin("mimas_wait_events");
+    mimas_platform_wait_events(_mimas_get_redraw_wait_timeout(timeout_ms));
+    _mimas_trace_end("mimas_wait_events");
+    mimas_dispatch_pending();
+}
+
+void mimas_post_empty_event() {
+    mimas_platform_post_empty_event();
+}
+
+void* mimas_get_event_handle() {
+    return mimas_platform_get_event_handle();
 }
 
 Mimas_Window* mimas_create_window(Mimas_Window_Create_Info const info) {
-    return mimas_platform_create_window(info);
+    Mimas_Window* const window = mimas_platform_create_window(info);
+    if(window) {
+        _mimas_register_window(window);
+    }
+    return window;
+}
+
+mimas_bool mimas_create_windows(Mimas_Window_Create_Info const* const infos, mimas_u32 const count, Mimas_Window** const windows) {
+    for(mimas_u32 i = 0; i < count; ++i) {
+        windows[i] = mimas_create_window(infos[i]);
+        if(!windows[i]) {
+            for(mimas_u32 j = 0; j < i; ++j) {
+                mimas_destroy_window(windows[j]);
+                windows[j] = NULL;
+            }
+            return mimas_false;
+        }
+    }
+    return mimas_true;
+}
+
+void mimas_set_window_pool_size(mimas_u32 const size) {
+    mimas_platform_set_window_pool_size(size);
 }
 
 void mimas_destroy_window(Mimas_Window* window) {
+    if(_mimas_defer_window_destruction(window)) {
+        return;
+    }
+
+    _mimas_unregister_window(window);
+    _mimas_free(window->text_input.data);
+    _mimas_free(window->update.title);
+    _mimas_gl_free_capture(window);
+    _mimas_gl_release_window(window);
     mimas_platform_destroy_window(window);
 }
 
@@ -28,6 +90,14 @@ mimas_bool mimas_close_requested(Mimas_Window* window) {
     return window->close_requested;
 }
 
+void mimas_set_window_event_mask(Mimas_Window* const window, mimas_u32 const mask) {
+    window->event_mask = mask & MIMAS_EVENT_MASK_ALL;
+}
+
+mimas_u32 mimas_get_window_event_mask(Mimas_Window* const window) {
+    return window->event_mask;
+}
+
 void mimas_set_window_activate_callback(Mimas_Window* window, mimas_window_activate_callback callback, void* user_data) {
     window->callbacks.window_activate = callback;
     window->callbacks.window_activate_data = user_data;
@@ -46,7 +116,7 @@ Mimas_Callback mimas_get_window_cursor_pos_callback(Mimas_Window* window) {
     return (Mimas_Callback){(void*)window->callbacks.cursor_pos, window->callbacks.cursor_pos_data};
 }
 
-void mimas_set_window_mouse_button_callback(Mimas_Window* window, mimas_window_cursor_pos_callback callback, void* user_data) {
+void mimas_set_window_mouse_button_callback(Mimas_Window* window, mimas_window_mouse_button_callback callback, void* user_data) {
     window->callbacks.mouse_button = callback;
     window->callbacks.mouse_button_data = user_data;
 }
@@ -64,6 +134,37 @@ Mimas_Callback mimas_get_window_key_callback(Mimas_Window* window) {
     return (Mimas_Callback){(void*)window->callbacks.key, window->callbacks.key_data};
 }
 
+void mimas_set_window_text_callback(Mimas_Window* window, mimas_window_text_callback callback, void* user_data) {
+    window->callbacks.text = callback;
+    window->callbacks.text_data = user_data;
+}
+
+Mimas_Callback mimas_get_window_text_callback(Mimas_Window* window) {
+    return (Mimas_Callback){(void*)window->callbacks.text, window->callbacks.text_data};
+}
+
+void mimas_set_window_resize_callback(Mimas_Window* window, mimas_window_resize_callback callback, void* user_data) {
+    window->callbacks.resize = callback;
+    window->callbacks.resize_data = user_data;
+}
+
+Mimas_Callback mimas_get_window_resize_callback(Mimas_Window* window) {
+    return (Mimas_Callback){(void*)window->callbacks.resize, window->callbacks.resize_data};
+}
+
+void mimas_set_window_resize_interval(Mimas_Window* const window, mimas_u32 const milliseconds) {
+    window->resize.interval_ms = milliseconds;
+}
+
+void mimas_set_window_content_scale_callback(Mimas_Window* window, mimas_window_content_scale_callback callback, void* user_data) {
+    window->callbacks.content_scale = callback;
+    window->callbacks.content_scale_data = user_data;
+}
+
+Mimas_Callback mimas_get_window_content_scale_callback(Mimas_Window* window) {
+    return (Mimas_Callback){(void*)window->callbacks.content_scale, window->callbacks.content_scale_data};
+}
+
 void mimas_set_window_hittest(Mimas_Window* window, mimas_window_hittest callback) {
     window->callbacks.hittest = callback;
 }
@@ -72,8 +173,18 @@ Mimas_Callback mimas_get_window_hittest(Mimas_Window* window) {
     return (Mimas_Callback){(void*)window->callbacks.hittest, NULL};
 }
 
+// Applies the recorded changes right away unless the window is in a transaction.
+static void flush_window_update(Mimas_Window* const window) {
+    if(!window->update.in_transaction) {
+        _mimas_commit_window_updates(&window, 1);
+    }
+}
+
 void mimas_set_window_pos(Mimas_Window* const window, mimas_i32 const x, mimas_i32 const y) {
-    mimas_platform_set_window_pos(window, x, y);
+    window->update.flags = (window->update.flags & ~MIMAS_WINDOW_UPDATE_CONTENT_POS) | MIMAS_WINDOW_UPDATE_POS;
+    window->update.x = x;
+    window->update.y = y;
+    flush_window_update(window);
 }
 
 void mimas_get_window_pos(Mimas_Window* const window, mimas_i32* const x, mimas_i32* const y) {
@@ -81,7 +192,10 @@ void mimas_get_window_pos(Mimas_Window* const window, mimas_i32* const x, mimas_
 }
 
 void mimas_set_window_content_pos(Mimas_Window* const window, mimas_i32 const x, mimas_i32 const y) {
-    mimas_platform_set_window_content_pos(window, x, y);
+    window->update.flags = (window->update.flags & ~MIMAS_WINDOW_UPDATE_POS) | MIMAS_WINDOW_UPDATE_CONTENT_POS;
+    window->update.x = x;
+    window->update.y = y;
+    flush_window_update(window);
 }
 
 void mimas_get_window_content_pos(Mimas_Window* const window, mimas_i32* const x, mimas_i32* const y) {
@@ -89,19 +203,101 @@ void mimas_get_window_content_pos(Mimas_Window* const window, mimas_i32* const x
 }
 
 void mimas_set_window_content_size(Mimas_Window* const window, mimas_i32 const width, mimas_i32 const height) {
-    mimas_platform_set_window_content_size(window, width, height);
+    window->update.flags |= MIMAS_WINDOW_UPDATE_CONTENT_SIZE;
+    window->update.width = width;
+    window->update.height = height;
+    flush_window_update(window);
 }
 
 void mimas_get_window_content_size(Mimas_Window* const window, mimas_i32* const width, mimas_i32* const height) {
     mimas_platform_get_window_content_size(window, width, height);
 }
 
+void mimas_get_window_framebuffer_size(Mimas_Window* const window, mimas_i32* const width, mimas_i32* const height) {
+    mimas_platform_get_window_framebuffer_size(window, width, height);
+}
+
+void mimas_get_window_content_scale(Mimas_Window* const window, float* const scale_x, float* const scale_y) {
+    *scale_x = window->content_scale;
+    *scale_y = window->content_scale;
+}
+
 void mimas_show_window(Mimas_Window* const window) {
-    mimas_platform_show_window(window);
+    window->update.flags |= MIMAS_WINDOW_UPDATE_VISIBLE;
+    window->update.visible = mimas_true;
+    flush_window_update(window);
 }
 
 void mimas_hide_window(Mimas_Window* const window) {
-    mimas_platform_hide_window(window);
+    window->update.flags |= MIMAS_WINDOW_UPDATE_VISIBLE;
+    window->update.visible = mimas_false;
+    flush_window_update(window);
+}
+
+Mimas_Window_Visibility mimas_get_window_visibility(Mimas_Window* const window) {
+    return (Mimas_Window_Visibility)_mimas_atomic_load_i32(&window->visibility.state);
+}
+
+void mimas_set_window_visibility_callback(Mimas_Window* const window, mimas_window_visibility_callback const callback, void* const user_data) {
+    window->callbacks.visibility = callback;
+    window->callbacks.visibility_data = user_data;
+}
+
+Mimas_Callback mimas_get_window_visibility_callback(Mimas_Window* const window) {
+    return (Mimas_Callback){(void*)window->callbacks.visibility, window->callbacks.visibility_data};
+}
+
+void mimas_set_window_auto_throttle(Mimas_Window* const window, mimas_u32 const interval_ms) {
+    _mimas_atomic_store_i32(&window->visibility.throttle_interval_ms, (mimas_i32)interval_ms);
+}
+
+void mimas_set_window_redraw_callback(Mimas_Window* const window, mimas_window_redraw_callback const callback, void* const user_data) {
+    window->callbacks.redraw = callback;
+    window->callbacks.redraw_data = user_data;
+}
+
+Mimas_Callback mimas_get_window_redraw_callback(Mimas_Window* const window) {
+    return (Mimas_Callback){(void*)window->callbacks.redraw, window->callbacks.redraw_data};
+}
+
+void mimas_request_redraw(Mimas_Window* const window) {
+    // Only the first request since the last redraw needs to wake up the event loop.
+    if(_mimas_atomic_cas_u64(&window->redraw.requested, 0, 1)) {
+        mimas_platform_post_empty_event();
+    }
+}
+
+void mimas_set_window_title(Mimas_Window* const window, char const* const title) {
+    mimas_u64 const size = strlen(title) + 1;
+    char* const title_copy = (char*)_mimas_malloc(size);
+    if(!title_copy) {
+        // TODO: Error
+        return;
+    }
+
+    memcpy(title_copy, title, size);
+    _mimas_free(window->update.title);
+    window->update.title = title_copy;
+    window->update.flags |= MIMAS_WINDOW_UPDATE_TITLE;
+    flush_window_update(window);
+}
+
+void mimas_set_window_decorated(Mimas_Window* const window, mimas_bool const decorated) {
+    window->update.flags |= MIMAS_WINDOW_UPDATE_DECORATED;
+    window->update.decorated = decorated;
+    flush_window_update(window);
+}
+
+void mimas_begin_window_update(Mimas_Window* const window) {
+    window->update.in_transaction = mimas_true;
+}
+
+void mimas_commit_window_update(Mimas_Window* const window) {
+    _mimas_commit_window_updates(&window, 1);
+}
+
+void mimas_commit_window_updates(Mimas_Window* const* const windows, mimas_u32 const count) {
+    _mimas_commit_window_updates(windows, count);
 }
 
 void mimas_restore_window(Mimas_Window* const window) {
@@ -116,8 +312,31 @@ void mimas_maximize_window(Mimas_Window* const window) {
     mimas_platform_maximize_window(window);
 }
 
+mimas_bool mimas_set_window_fullscreen(Mimas_Window* const window, Mimas_Fullscreen_Mode const mode, mimas_u32 const monitor_index, Mimas_Video_Mode const* const video_mode) {
+    return mimas_platform_set_window_fullscreen(window, mode, monitor_index, video_mode);
+}
+
+Mimas_Fullscreen_Mode mimas_get_window_fullscreen(Mimas_Window* const window) {
+    return window->fullscreen;
+}
+
 void mimas_swap_buffers(Mimas_Window* const window) {
+    mimas_u32 const throttle_interval_ms = (mimas_u32)_mimas_atomic_load_i32(&window->visibility.throttle_interval_ms);
+    if(throttle_interval_ms != 0 && _mimas_atomic_load_i32(&window->visibility.state) != MIMAS_WINDOW_VISIBLE) {
+        _mimas_trace_begin("mimas_swap_buffers_throttled");
+        mimas_platform_sleep_ms(throttle_interval_ms);
+        _mimas_trace_end("mimas_swap_buffers_throttled");
+        return;
+    }
+
+    _mimas_trace_begin("mimas_swap_buffers");
+    mimas_u64 const start = _mimas_stats_begin();
+    if(window->capture) {
+        _mimas_gl_capture_frame(window);
+    }
     mimas_platform_swap_buffers(window);
+    _mimas_stats_end_swap(window, start);
+    _mimas_trace_end("mimas_swap_buffers");
 }
 
 void mimas_set_swap_interval(mimas_i32 const interval) {
@@ -128,6 +347,15 @@ mimas_i32 mimas_get_swap_interval() {
     return mimas_platform_get_swap_interval();
 }
 
+void mimas_inject_key(Mimas_Window* const window, Mimas_Key const key, Mimas_Key_Action const action) {
+    if(key < 0 || key >= (Mimas_Key)ARRAY_SIZE(window->keys)) {
+        return;
+    }
+
+    // Take the time now rather than on delivery so that the measurement includes the time the event spends in the queue.
+    mimas_platform_inject_key(window, key, action, mimas_platform_get_time_ns());
+}
+
 void mimas_set_cursor_mode(Mimas_Window* const window, Mimas_Cursor_Mode const cursor_mode) {
     mimas_platform_set_cursor_mode(window, cursor_mode);
 }
@@ -138,4 +366,64 @@ void mimas_get_cursor_pos(mimas_i32* const x, mimas_i32* const y) {
 
 Mimas_Mouse_Button_Action mimas_get_mouse_button(Mimas_Mouse_Button button) {
     return mimas_platform_get_mouse_button(button);
-}
\ No newline at end of file
+}
+
+mimas_u32 mimas_get_monitors(Mimas_Monitor* const monitors, mimas_u32 const capacity) {
+    return mimas_platform_get_monitors(monitors, capacity);
+}
+
+Mimas_Screen_Capture* mimas_create_screen_capture(mimas_u32 const monitor_index) {
+    return mimas_platform_create_screen_capture(monitor_index);
+}
+
+void mimas_destroy_screen_capture(Mimas_Screen_Capture* const capture) {
+    mimas_platform_destroy_screen_capture(capture);
+}
+
+mimas_bool mimas_capture_screen(Mimas_Screen_Capture* const capture, mimas_u32 const timeout_ms, Mimas_Screen_Frame* const frame) {
+    _mimas_trace_begin("mimas_capture_screen");
+    mimas_bool const res = mimas_platform_capture_screen(capture, timeout_ms, frame);
+    _mimas_trace_end("mimas_capture_screen");
+    return res;
+}
+
+void mimas_set_monitors_changed_callback(mimas_monitors_changed_callback const callback, void* const user_data) {
+    Mimas_Internal* const _mimas = _mimas_get_mimas_internal();
+    _mimas->monitors_changed = callback;
+    _mimas->monitors_changed_data = user_data;
+    // Establish the baseline the changes are reported against.
+    mimas_platform_update_monitors();
+}
+
+Mimas_Callback mimas_get_monitors_changed_callback() {
+    Mimas_Internal* const _mimas = _mimas_get_mimas_internal();
+    return (Mimas_Callback){(void*)_mimas->monitors_changed, _mimas->monitors_changed_data};
+}
+
+mimas_bool mimas_set_gamepad_input_enabled(mimas_bool const enabled) {
+    return mimas_platform_set_gamepad_input_enabled(enabled);
+}
+
+mimas_bool mimas_get_gamepad_state(mimas_u32 const index, Mimas_Gamepad_State* const state) {
+    return mimas_platform_get_gamepad_state(index, state);
+}
+
+mimas_u64 mimas_get_time_ns() {
+    return mimas_platform_get_time_ns();
+}
+
+mimas_bool mimas_set_clipboard(Mimas_Clipboard_Offer const offer) {
+    return mimas_platform_set_clipboard(offer);
+}
+
+void mimas_write_clipboard_data(Mimas_Clipboard_Sink* const sink, void const* const data, mimas_u64 const size) {
+    mimas_platform_write_clipboard_data(sink, data, size);
+}
+
+mimas_bool mimas_get_clipboard(char const* const mime_type, mimas_clipboard_receive_callback const callback, void* const user_data) {
+    return mimas_platform_get_clipboard(mime_type, callback, user_data);
+}
+
+mimas_bool mimas_has_clipboard_data(char const* const mime_type) {
+    return mimas_platform_has_clipboard_data(mime_type);
+}
@@ -2,10 +2,23 @@
 #include <internal.h>
 #include <platform_gl.h>
 #include <platform.h>
+#include <trace.h>
+#include <utils.h>
+
+#include <string.h>
+
+// Context and window made current on this thread through mimas_make_context_current.
+// The window is tracked by its serial because it may be destroyed on another thread and its address reused.
+static MIMAS_THREAD_LOCAL Mimas_GL_Context* current_context = NULL;
+static MIMAS_THREAD_LOCAL mimas_u64 current_window_serial = 0;
+
+static mimas_u64 get_window_serial(Mimas_Window* const window) {
+    return window ? window->serial : 0;
+}
 
 mimas_bool mimas_init_with_gl() {
     _mimas_init_internal(MIMAS_BACKEND_GL);
-    mimas_bool const res = mimas_platform_init(MIMAS_BACKEND_GL);
+    mimas_bool const res = _mimas_init_platform(MIMAS_BACKEND_GL);
     if(!res) {
         _mimas_terminate_internal();
     }
@@ -13,13 +26,150 @@ mimas_bool mimas_init_with_gl() {
 }
 
 Mimas_GL_Context* mimas_create_gl_context(mimas_i32 const version_major, mimas_i32 const version_minor, Mimas_GL_Profile const profile) {
-    return mimas_platform_create_gl_context(version_major, version_minor, profile);
+    Mimas_GL_Context_Create_Info const info = {
+        .version_major = version_major,
+        .version_minor = version_minor,
+        .profile = profile,
+        .flags = 0,
+        .release_behavior = MIMAS_GL_RELEASE_BEHAVIOR_FLUSH,
+        .window = NULL,
+    };
+    return mimas_create_gl_context_with_info(&info);
+}
+
+Mimas_GL_Context* mimas_create_gl_context_with_info(Mimas_GL_Context_Create_Info const* const info) {
+    // KHR_no_error forbids debug and robust contexts.
+    if((info->flags & MIMAS_GL_CONTEXT_NO_ERROR) && (info->flags & (MIMAS_GL_CONTEXT_DEBUG | MIMAS_GL_CONTEXT_ROBUST))) {
+        // TODO: Error
+        return NULL;
+    }
+
+    Mimas_GL_Context* const ctx = (Mimas_GL_Context*)_mimas_malloc(sizeof(Mimas_GL_Context));
+    memset(ctx, 0, sizeof(Mimas_GL_Context));
+    if(!mimas_platform_create_gl_context(ctx, info)) {
+        _mimas_free(ctx);
+        return NULL;
+    }
+    return ctx;
 }
 
 void mimas_destroy_gl_context(Mimas_GL_Context* const ctx) {
     mimas_platform_destroy_gl_context(ctx);
+    if(current_context == ctx) {
+        current_context = NULL;
+        current_window_serial = 0;
+    }
+
+    for(mimas_u32 i = 0; i < ctx->proc_capacity; ++i) {
+        _mimas_free(ctx->procs[i].name);
+    }
+    _mimas_free(ctx->procs);
+    _mimas_free(ctx);
 }
 
 mimas_bool mimas_make_context_current(Mimas_Window* const window, Mimas_GL_Context* const ctx) {
-    return mimas_platform_make_context_current(window, ctx);
+    // Switching contexts flushes the previous one in most drivers, so render loops that make their context current every frame
+    // should not pay for it. The window only matters while a context is current.
+    if(ctx == current_context && (!ctx || get_window_serial(window) == current_window_serial)) {
+        return mimas_true;
+    }
+
+    _mimas_trace_begin("mimas_make_context_current");
+    mimas_bool const res = mimas_platform_make_context_current(window, ctx);
+    if(res) {
+        current_context = ctx;
+        current_window_serial = ctx ? get_window_serial(window) : 0;
+    }
+    _mimas_trace_end("mimas_make_context_current");
+    return res;
+}
+
+Mimas_GL_Context* mimas_get_current_context() {
+    return current_context;
+}
+
+void _mimas_gl_release_window(Mimas_Window* const window) {
+    // Unbind the context from the window on this thread. Other threads keep its serial, which no later window can match.
+    if(current_context && current_window_serial == window->serial) {
+        mimas_platform_make_context_current(window, NULL);
+        current_context = NULL;
+        current_window_serial = 0;
+    }
+}
+
+// FNV-1a
+static mimas_u64 hash_proc_name(char const* name) {
+    mimas_u64 hash = 14695981039346656037ULL;
+    for(; *name; ++name) {
+        hash = (hash ^ (mimas_u8)*name) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Returns the slot of name or the empty slot it should be inserted into.
+static Mimas_GL_Proc_Entry* find_proc_entry(Mimas_GL_Context const* const ctx, char const* const name, mimas_u64 const hash) {
+    mimas_u32 const mask = ctx->proc_capacity - 1;
+    for(mimas_u32 i = (mimas_u32)hash & mask;; i = (i + 1) & mask) {
+        Mimas_GL_Proc_Entry* const entry = &ctx->procs[i];
+        if(!entry->name || (entry->hash == hash && strcmp(entry->name, name) == 0)) {
+            return entry;
+        }
+    }
+}
+
+static void grow_proc_table(Mimas_GL_Context* const ctx) {
+    Mimas_GL_Proc_Entry* const procs = ctx->procs;
+    mimas_u32 const capacity = ctx->proc_capacity;
+    ctx->proc_capacity = capacity ? capacity * 2 : 256;
+    ctx->procs = (Mimas_GL_Proc_Entry*)_mimas_malloc(sizeof(Mimas_GL_Proc_Entry) * ctx->proc_capacity);
+    memset(ctx->procs, 0, sizeof(Mimas_GL_Proc_Entry) * ctx->proc_capacity);
+    for(mimas_u32 i = 0; i < capacity; ++i) {
+        if(procs[i].name) {
+            *find_proc_entry(ctx, procs[i].name, procs[i].hash) = procs[i];
+        }
+    }
+    _mimas_free(procs);
+}
+
+static Mimas_GL_Proc get_proc_address(Mimas_GL_Context* const ctx, char const* const name) {
+    // Keep the load factor at or below 1/2 so that probe sequences stay short.
+    if((ctx->proc_count + 1) * 2 > ctx->proc_capacity) {
+        grow_proc_table(ctx);
+    }
+
+    mimas_u64 const hash = hash_proc_name(name);
+    Mimas_GL_Proc_Entry* const entry = find_proc_entry(ctx, name, hash);
+    if(!entry->name) {
+        mimas_u64 const size = strlen(name) + 1;
+        entry->hash = hash;
+        entry->name = (char*)_mimas_malloc(size);
+        memcpy(entry->name, name, size);
+        entry->proc = mimas_platform_get_gl_proc_address(name);
+        ctx->proc_count += 1;
+    }
+    return entry->proc;
+}
+
+Mimas_GL_Proc mimas_gl_get_proc_address(char const* const name) {
+    if(!current_context) {
+        return NULL;
+    }
+    return get_proc_address(current_context, name);
+}
+
+mimas_u32 mimas_gl_load_procs(char const* const* const names, mimas_u32 const count, Mimas_GL_Proc* const procs) {
+    if(!current_context) {
+        memset(procs, 0, sizeof(Mimas_GL_Proc) * count);
+        return 0;
+    }
+
+    _mimas_trace_begin("mimas_gl_load_procs");
+    // The caller keeps the entry points in its own table, so we bypass the cache and do not copy every name into it.
+    mimas_u32 loaded = 0;
+    for(mimas_u32 i = 0; i < count; ++i) {
+        procs[i] = mimas_platform_get_gl_proc_address(names[i]);
+        loaded += procs[i] != NULL;
+    }
+    _mimas_trace_end("mimas_gl_load_procs");
+    return loaded;
 }
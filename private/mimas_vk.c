@@ -5,7 +5,7 @@
 
 mimas_bool mimas_init_with_vk() {
     _mimas_init_internal(MIMAS_BACKEND_VK);
-    mimas_bool const res =  mimas_platform_init(MIMAS_BACKEND_VK);
+    mimas_bool const res = _mimas_init_platform(MIMAS_BACKEND_VK);
     if(!res) {
         _mimas_terminate_internal();
     }
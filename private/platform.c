@@ -0,0 +1,100 @@
+#include <platform.h>
+#include <mimas/mimas.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(MIMAS_PLATFORM_SINGLE_BACKEND)
+Mimas_Platform_Vtable const* _mimas_platform = NULL;
+#endif
+
+static char platform_hint[128] = {0};
+static Mimas_Platform_Vtable const* selected_platform = NULL;
+
+#if !defined(MIMAS_PLATFORM_SINGLE_BACKEND)
+// Backends in the order they are tried when neither a hint nor MIMAS_PLATFORM is set.
+static Mimas_Platform_Vtable const* const platforms[] = {
+#if defined(MIMAS_PLATFORM_HAS_WIN32)
+    &mimas_win_platform_vtable,
+#endif
+#if defined(MIMAS_PLATFORM_HAS_HEADLESS)
+    &mimas_headless_platform_vtable,
+#endif
+};
+
+static Mimas_Platform_Vtable const* find_platform(char const* const name, mimas_u64 const length) {
+    for(mimas_u32 i = 0; i < sizeof(platforms) / sizeof(platforms[0]); ++i) {
+        if(strlen(platforms[i]->name) == length && strncmp(platforms[i]->name, name, length) == 0) {
+            return platforms[i];
+        }
+    }
+    return NULL;
+}
+
+static mimas_bool try_platform(Mimas_Platform_Vtable const* const platform, Mimas_Backend const backend) {
+    _mimas_platform = platform;
+    if(platform->init(backend)) {
+        selected_platform = platform;
+        return mimas_true;
+    }
+    _mimas_platform = NULL;
+    return mimas_false;
+}
+#endif
+
+mimas_bool _mimas_init_platform(Mimas_Backend const backend) {
+#if defined(MIMAS_PLATFORM_SINGLE_BACKEND)
+    if(!_MIMAS_CONCAT(MIMAS_PLATFORM_SINGLE_BACKEND, init)(backend)) {
+        return mimas_false;
+    }
+    selected_platform = &_MIMAS_CONCAT(MIMAS_PLATFORM_SINGLE_BACKEND, vtable);
+    return mimas_true;
+#else
+    char const* names = getenv("MIMAS_PLATFORM");
+    if(!names || names[0] == '\0') {
+        names = platform_hint;
+    }
+
+    if(names[0] != '\0') {
+        // Comma-separated list of backend names, tried in order. Unknown names are skipped.
+        while(*names) {
+            char const* const end = strchr(names, ',');
+            mimas_u64 const length = end ? (mimas_u64)(end - names) : strlen(names);
+            Mimas_Platform_Vtable const* const platform = find_platform(names, length);
+            if(platform && try_platform(platform, backend)) {
+                return mimas_true;
+            }
+            names += length + (end != NULL);
+        }
+        return mimas_false;
+    }
+
+    // The headless backend is only used when requested explicitly.
+    for(mimas_u32 i = 0; i < sizeof(platforms) / sizeof(platforms[0]); ++i) {
+        if(strcmp(platforms[i]->name, "headless") != 0 && try_platform(platforms[i], backend)) {
+            return mimas_true;
+        }
+    }
+    return mimas_false;
+#endif
+}
+
+void _mimas_terminate_platform(Mimas_Backend const backend) {
+    _MIMAS_PLATFORM_FUNCTION(terminate)(backend);
+#if !defined(MIMAS_PLATFORM_SINGLE_BACKEND)
+    _mimas_platform = NULL;
+#endif
+    selected_platform = NULL;
+}
+
+void mimas_set_platform_hint(char const* const platforms) {
+    if(platforms) {
+        strncpy(platform_hint, platforms, sizeof(platform_hint) - 1);
+    } else {
+        platform_hint[0] = '\0';
+    }
+}
+
+char const* mimas_get_platform_name() {
+    return selected_platform ? selected_platform->name : NULL;
+}
@@ -2,35 +2,171 @@
 #define MIMAS_MIMAS_PLATFORM_H_INCLUDE
 
 #include <internal.h>
+#include <platform_gl.h>
+#include <platform_vk.h>
 #include <mimas/mimas.h>
 
-mimas_bool mimas_platform_init(Mimas_Backend);
-void mimas_platform_terminate(Mimas_Backend);
+// Every function a platform backend implements as X(return type, name, parameters).
+// A backend defines its functions with its own prefix, e.g. mimas_win_platform_init, and lists them in a Mimas_Platform_Vtable.
+//
+// init(backend)
+// terminate(backend)
+// poll_events - Returns the number of native events that have been dispatched.
+// wait_events(timeout_ms) - Blocks until native events or wakeups are available or timeout_ms has elapsed.
+// apply_window_updates(windows, count) - Applies the changes recorded in window->update of every window. Does not clear them.
+// inject_key(window, key, action, timestamp_ns) - Queues a key event that the next poll_events delivers like a native one.
+//   Called from any thread. The input_to_present_ns measurement of the event starts at timestamp_ns.
+// set_window_fullscreen(window, mode, monitor_index, video_mode) - Also updates window->fullscreen. Leaves the window unchanged on failure.
+// create_gl_context(ctx, info) - Creates the native context of ctx, which has been allocated by the caller.
+//   Flags the backend cannot honour are dropped where Mimas_GL_Context_Flags allows it.
+// get_gl_proc_address(name) - Resolves name for the context current on the calling thread without caching.
+// get_frame_timing(window, vblank_ns, period_ns) - Returns the refresh period of the display that presents window
+//   and the time of any past vertical blank on the mimas_platform_get_time_ns clock.
+//   vblank_ns is 0 if the backend knows the period but not the phase. Returns mimas_false if neither is known.
+// update_monitors - Refreshes the monitors if the system has notified us of a change.
+//   Returns mimas_true if the monitors differ from the ones at the previous call, including changes picked up by other queries.
+#define MIMAS_PLATFORM_FUNCTIONS(X) \
+    X(mimas_bool, init, (Mimas_Backend)) \
+    X(void, terminate, (Mimas_Backend)) \
+    X(mimas_u32, poll_events, (void)) \
+    X(void, wait_events, (mimas_u32 timeout_ms)) \
+    X(void, post_empty_event, (void)) \
+    X(void*, get_event_handle, (void)) \
+    X(Mimas_Window*, create_window, (Mimas_Window_Create_Info)) \
+    X(void, set_window_pool_size, (mimas_u32 size)) \
+    X(void, destroy_window, (Mimas_Window*)) \
+    X(void, get_window_pos, (Mimas_Window*, mimas_i32* x, mimas_i32* y)) \
+    X(void, get_window_content_pos, (Mimas_Window*, mimas_i32* x, mimas_i32* y)) \
+    X(void, get_window_content_size, (Mimas_Window*, mimas_i32* width, mimas_i32* height)) \
+    X(void, get_window_framebuffer_size, (Mimas_Window*, mimas_i32* width, mimas_i32* height)) \
+    X(void, apply_window_updates, (Mimas_Window* const* windows, mimas_u32 count)) \
+    X(void, restore_window, (Mimas_Window*)) \
+    X(void, minimize_window, (Mimas_Window*)) \
+    X(void, maximize_window, (Mimas_Window*)) \
+    X(mimas_bool, set_window_fullscreen, (Mimas_Window*, Mimas_Fullscreen_Mode, mimas_u32 monitor_index, Mimas_Video_Mode const* video_mode)) \
+    X(void, swap_buffers, (Mimas_Window*)) \
+    X(void, set_swap_interval, (mimas_i32)) \
+    X(mimas_i32, get_swap_interval, (void)) \
+    X(void, inject_key, (Mimas_Window*, Mimas_Key, Mimas_Key_Action, mimas_u64 timestamp_ns)) \
+    X(void, set_cursor_mode, (Mimas_Window*, Mimas_Cursor_Mode)) \
+    X(void, get_cursor_pos, (mimas_i32* x, mimas_i32* y)) \
+    X(Mimas_Mouse_Button_Action, get_mouse_button, (Mimas_Mouse_Button button)) \
+    X(mimas_u32, get_monitors, (Mimas_Monitor* monitors, mimas_u32 capacity)) \
+    X(mimas_bool, get_frame_timing, (Mimas_Window*, mimas_u64* vblank_ns, mimas_u64* period_ns)) \
+    X(Mimas_Screen_Capture*, create_screen_capture, (mimas_u32 monitor_index)) \
+    X(void, destroy_screen_capture, (Mimas_Screen_Capture*)) \
+    X(mimas_bool, capture_screen, (Mimas_Screen_Capture*, mimas_u32 timeout_ms, Mimas_Screen_Frame* frame)) \
+    X(mimas_bool, update_monitors, (void)) \
+    X(mimas_bool, set_clipboard, (Mimas_Clipboard_Offer offer)) \
+    X(void, write_clipboard_data, (Mimas_Clipboard_Sink* sink, void const* data, mimas_u64 size)) \
+    X(mimas_bool, get_clipboard, (char const* mime_type, mimas_clipboard_receive_callback callback, void* user_data)) \
+    X(mimas_bool, has_clipboard_data, (char const* mime_type)) \
+    X(mimas_bool, set_gamepad_input_enabled, (mimas_bool enabled)) \
+    X(mimas_bool, get_gamepad_state, (mimas_u32 index, Mimas_Gamepad_State* state)) \
+    X(mimas_bool, create_gl_context, (Mimas_GL_Context* ctx, Mimas_GL_Context_Create_Info const* info)) \
+    X(void, destroy_gl_context, (Mimas_GL_Context* ctx)) \
+    X(mimas_bool, make_context_current, (Mimas_Window* window, Mimas_GL_Context* ctx)) \
+    X(Mimas_GL_Proc, get_gl_proc_address, (char const* name)) \
+    X(char const**, get_vk_extensions, (void)) \
+    X(VkResult, create_vk_surface, (Mimas_Window*, VkInstance, struct VkAllocationCallbacks const*, VkSurfaceKHR*))
 
-void mimas_platform_poll_events();
+#define _MIMAS_PLATFORM_VTABLE_ENTRY(return_type, function, parameters) return_type (*function) parameters;
 
-Mimas_Window* mimas_platform_create_window(Mimas_Window_Create_Info);
-void mimas_platform_destroy_window(Mimas_Window*);
+typedef struct Mimas_Platform_Vtable {
+    // Name used to select the backend through mimas_set_platform_hint and MIMAS_PLATFORM.
+    char const* name;
+    MIMAS_PLATFORM_FUNCTIONS(_MIMAS_PLATFORM_VTABLE_ENTRY)
+} Mimas_Platform_Vtable;
 
-void mimas_platform_set_window_pos(Mimas_Window*, mimas_i32 x, mimas_i32 y);
-void mimas_platform_get_window_pos(Mimas_Window*, mimas_i32* x, mimas_i32* y);
-void mimas_platform_set_window_content_pos(Mimas_Window*, mimas_i32 x, mimas_i32 y);
-void mimas_platform_get_window_content_pos(Mimas_Window*, mimas_i32* x, mimas_i32* y);
-void mimas_platform_set_window_content_size(Mimas_Window*, mimas_i32 width, mimas_i32 height);
-void mimas_platform_get_window_content_size(Mimas_Window*, mimas_i32* width, mimas_i32* height);
+#define _MIMAS_CONCAT_IMPL(a, b) a##b
+#define _MIMAS_CONCAT(a, b) _MIMAS_CONCAT_IMPL(a, b)
 
-void mimas_platform_show_window(Mimas_Window*);
-void mimas_platform_hide_window(Mimas_Window*);
-void mimas_platform_restore_window(Mimas_Window*);
-void mimas_platform_minimize_window(Mimas_Window*);
-void mimas_platform_maximize_window(Mimas_Window*);
+#if defined(MIMAS_PLATFORM_SINGLE_BACKEND)
+// MIMAS_PLATFORM_SINGLE_BACKEND is the prefix of the only compiled backend, which we call directly.
+#define _MIMAS_DECLARE_PLATFORM_FUNCTION(return_type, function, parameters) return_type _MIMAS_CONCAT(MIMAS_PLATFORM_SINGLE_BACKEND, function) parameters;
+MIMAS_PLATFORM_FUNCTIONS(_MIMAS_DECLARE_PLATFORM_FUNCTION)
+#undef _MIMAS_DECLARE_PLATFORM_FUNCTION
+#define _MIMAS_PLATFORM_FUNCTION(function) _MIMAS_CONCAT(MIMAS_PLATFORM_SINGLE_BACKEND, function)
+#else
+// The backend selected by _mimas_init_platform.
+extern Mimas_Platform_Vtable const* _mimas_platform;
+#define _MIMAS_PLATFORM_FUNCTION(function) _mimas_platform->function
+#endif
 
-void mimas_platform_swap_buffers(Mimas_Window*);
-void mimas_platform_set_swap_interval(mimas_i32);
-mimas_i32 mimas_platform_get_swap_interval();
+#if defined(MIMAS_PLATFORM_HAS_WIN32)
+extern Mimas_Platform_Vtable const mimas_win_platform_vtable;
+#endif
+#if defined(MIMAS_PLATFORM_HAS_HEADLESS)
+extern Mimas_Platform_Vtable const mimas_headless_platform_vtable;
+#endif
 
-void mimas_platform_set_cursor_mode(Mimas_Window*, Mimas_Cursor_Mode);
-void mimas_platform_get_cursor_pos(mimas_i32* x, mimas_i32* y);
-Mimas_Mouse_Button_Action mimas_platform_get_mouse_button(Mimas_Mouse_Button button);
+// Selects a backend and initializes it.
+mimas_bool _mimas_init_platform(Mimas_Backend);
+void _mimas_terminate_platform(Mimas_Backend);
+
+#define mimas_platform_poll_events _MIMAS_PLATFORM_FUNCTION(poll_events)
+#define mimas_platform_wait_events _MIMAS_PLATFORM_FUNCTION(wait_events)
+#define mimas_platform_post_empty_event _MIMAS_PLATFORM_FUNCTION(post_empty_event)
+#define mimas_platform_get_event_handle _MIMAS_PLATFORM_FUNCTION(get_event_handle)
+#define mimas_platform_create_window _MIMAS_PLATFORM_FUNCTION(create_window)
+#define mimas_platform_set_window_pool_size _MIMAS_PLATFORM_FUNCTION(set_window_pool_size)
+#define mimas_platform_destroy_window _MIMAS_PLATFORM_FUNCTION(destroy_window)
+#define mimas_platform_get_window_pos _MIMAS_PLATFORM_FUNCTION(get_window_pos)
+#define mimas_platform_get_window_content_pos _MIMAS_PLATFORM_FUNCTION(get_window_content_pos)
+#define mimas_platform_get_window_content_size _MIMAS_PLATFORM_FUNCTION(get_window_content_size)
+#define mimas_platform_get_window_framebuffer_size _MIMAS_PLATFORM_FUNCTION(get_window_framebuffer_size)
+#define mimas_platform_apply_window_updates _MIMAS_PLATFORM_FUNCTION(apply_window_updates)
+#define mimas_platform_restore_window _MIMAS_PLATFORM_FUNCTION(restore_window)
+#define mimas_platform_minimize_window _MIMAS_PLATFORM_FUNCTION(minimize_window)
+#define mimas_platform_maximize_window _MIMAS_PLATFORM_FUNCTION(maximize_window)
+#define mimas_platform_set_window_fullscreen _MIMAS_PLATFORM_FUNCTION(set_window_fullscreen)
+#define mimas_platform_swap_buffers _MIMAS_PLATFORM_FUNCTION(swap_buffers)
+#define mimas_platform_set_swap_interval _MIMAS_PLATFORM_FUNCTION(set_swap_interval)
+#define mimas_platform_get_swap_interval _MIMAS_PLATFORM_FUNCTION(get_swap_interval)
+#define mimas_platform_inject_key _MIMAS_PLATFORM_FUNCTION(inject_key)
+#define mimas_platform_set_cursor_mode _MIMAS_PLATFORM_FUNCTION(set_cursor_mode)
+#define mimas_platform_get_cursor_pos _MIMAS_PLATFORM_FUNCTION(get_cursor_pos)
+#define mimas_platform_get_mouse_button _MIMAS_PLATFORM_FUNCTION(get_mouse_button)
+#define mimas_platform_get_monitors _MIMAS_PLATFORM_FUNCTION(get_monitors)
+#define mimas_platform_get_frame_timing _MIMAS_PLATFORM_FUNCTION(get_frame_timing)
+#define mimas_platform_create_screen_capture _MIMAS_PLATFORM_FUNCTION(create_screen_capture)
+#define mimas_platform_destroy_screen_capture _MIMAS_PLATFORM_FUNCTION(destroy_screen_capture)
+#define mimas_platform_capture_screen _MIMAS_PLATFORM_FUNCTION(capture_screen)
+#define mimas_platform_update_monitors _MIMAS_PLATFORM_FUNCTION(update_monitors)
+#define mimas_platform_set_clipboard _MIMAS_PLATFORM_FUNCTION(set_clipboard)
+#define mimas_platform_write_clipboard_data _MIMAS_PLATFORM_FUNCTION(write_clipboard_data)
+#define mimas_platform_get_clipboard _MIMAS_PLATFORM_FUNCTION(get_clipboard)
+#define mimas_platform_has_clipboard_data _MIMAS_PLATFORM_FUNCTION(has_clipboard_data)
+#define mimas_platform_set_gamepad_input_enabled _MIMAS_PLATFORM_FUNCTION(set_gamepad_input_enabled)
+#define mimas_platform_get_gamepad_state _MIMAS_PLATFORM_FUNCTION(get_gamepad_state)
+#define mimas_platform_create_gl_context _MIMAS_PLATFORM_FUNCTION(create_gl_context)
+#define mimas_platform_destroy_gl_context _MIMAS_PLATFORM_FUNCTION(destroy_gl_context)
+#define mimas_platform_make_context_current _MIMAS_PLATFORM_FUNCTION(make_context_current)
+#define mimas_platform_get_gl_proc_address _MIMAS_PLATFORM_FUNCTION(get_gl_proc_address)
+#define mimas_platform_get_vk_extensions _MIMAS_PLATFORM_FUNCTION(get_vk_extensions)
+#define mimas_platform_create_vk_surface _MIMAS_PLATFORM_FUNCTION(create_vk_surface)
+
+// Operating system services shared by all backends. May be called before mimas is initialized.
+
+// Monotonic time in nanoseconds.
+mimas_u64 mimas_platform_get_time_ns();
+mimas_u32 mimas_platform_get_thread_id();
+mimas_u32 mimas_platform_get_process_id();
+void mimas_platform_sleep_ms(mimas_u32 milliseconds);
+
+// Named shared memory and events for exchanging data between processes. Names are UTF-8.
+// The create and open functions return the mapped view and store the handle of the mapping in handle, or return NULL on failure.
+// Creation fails if the name is in use, unless the process that created it has exited without closing it.
+void* mimas_platform_create_shared_memory(char const* name, mimas_u64 size, void** handle);
+// Stores the size of the view in size. It may be rounded up to whole pages.
+void* mimas_platform_open_shared_memory(char const* name, void** handle, mimas_u64* size);
+void mimas_platform_close_shared_memory(void* handle, void* view);
+// Auto-reset events. A signal releases one waiter.
+void* mimas_platform_create_named_event(char const* name);
+void* mimas_platform_open_named_event(char const* name);
+void mimas_platform_close_named_event(void* event);
+void mimas_platform_signal_named_event(void* event);
+// Returns mimas_true if the event has been signalled before timeout_ms elapsed.
+mimas_bool mimas_platform_wait_named_event(void* event, mimas_u32 timeout_ms);
 
 #endif // !MIMAS_MIMAS_PLATFORM_H_INCLUDE
@@ -3,11 +3,24 @@
 
 #include <mimas/mimas_gl.h>
 
-mimas_bool mimas_platform_init_gl_backend();
-void mimas_platform_terminate_gl_backend();
+typedef struct {
+    mimas_u64 hash;
+    char* name;
+    Mimas_GL_Proc proc;
+} Mimas_GL_Proc_Entry;
 
-Mimas_GL_Context* mimas_platform_create_gl_context(mimas_i32 major, mimas_i32 minor, Mimas_GL_Profile profile);
-void mimas_platform_destroy_gl_context(Mimas_GL_Context* ctx);
-mimas_bool mimas_platform_make_context_current(Mimas_Window* const window, Mimas_GL_Context* const ctx);
+struct Mimas_GL_Context {
+    // Context of the backend, e.g. HGLRC on Windows.
+    void* native_context;
+    // Open addressing hash table of the entry points resolved for this context.
+    // Unavailable functions are cached too, with a NULL proc.
+    Mimas_GL_Proc_Entry* procs;
+    mimas_u32 proc_count;
+    // Always a power of 2.
+    mimas_u32 proc_capacity;
+};
+
+// Releases the context current on the calling thread if it is bound to window, which is being destroyed.
+void _mimas_gl_release_window(Mimas_Window* window);
 
 #endif // !MIMAS_PLATFORM_GL_H_INCLUDE
@@ -18,12 +18,8 @@ typedef enum VkResult {
     VK_SUCCESS = 0,
     VK_ERROR_OUT_OF_HOST_MEMORY = -1,
     VK_ERROR_OUT_OF_DEVICE_MEMORY = -2,
+    VK_ERROR_INITIALIZATION_FAILED = -3,
     VK_RESULT_MAX_ENUM = 0x7FFFFFFF
 } VkResult;
 
-mimas_bool mimas_platform_init_vk_backend();
-void mimas_platform_terminate_vk_backend();
-char const** mimas_platform_get_vk_extensions();
-VkResult mimas_platform_create_vk_surface(Mimas_Window*, VkInstance, struct VkAllocationCallbacks const*, VkSurfaceKHR*);
-
 #endif // !MIMAS_PLATFORM_VK_H_INCLUDE
@@ -0,0 +1,195 @@
+#include <platform.h>
+#include <internal.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// POSIX object names are limited to NAME_MAX on most systems.
+#define MIMAS_POSIX_OBJECT_NAME_SIZE 256
+
+typedef struct {
+    mimas_u64 size;
+    // The creator removes the name when it closes the memory, which matches the lifetime of Win32 mappings
+    // as long as the exporter outlives its readers.
+    mimas_bool owner;
+    // Kept open by the creator to hold an exclusive lock that tells other processes that the memory is alive.
+    // The system releases the lock if the creator crashes. -1 for memory that has been opened.
+    int lock_fd;
+    char name[MIMAS_POSIX_OBJECT_NAME_SIZE];
+} Mimas_Posix_Shared_Memory;
+
+// Writes the name prefixed with a slash as required by shm_open and sem_open. Returns mimas_false if the name does not fit.
+static mimas_bool make_object_name(char const* const name, char* const buffer) {
+    int const length = snprintf(buffer, MIMAS_POSIX_OBJECT_NAME_SIZE, "/%s", name);
+    return length > 0 && length < MIMAS_POSIX_OBJECT_NAME_SIZE;
+}
+
+// Unlike Win32 mappings, shared memory outlives a creator that crashed before it could remove the name.
+// Removes the memory if nobody holds its lock. Returns mimas_true if it has been removed.
+static mimas_bool remove_stale_shared_memory(char const* const object_name) {
+    int const fd = shm_open(object_name, O_RDWR, 0);
+    if(fd < 0) {
+        return mimas_false;
+    }
+
+    // Fails with EWOULDBLOCK while the creator is alive, or with another error if the system does not support locking shared memory.
+    mimas_bool const stale = flock(fd, LOCK_EX | LOCK_NB) == 0;
+    close(fd);
+    if(stale) {
+        shm_unlink(object_name);
+    }
+    return stale;
+}
+
+static void* map_shared_memory(char const* const name, mimas_u64 size, void** const handle, mimas_u64* const mapped_size, mimas_bool const create) {
+    Mimas_Posix_Shared_Memory* const memory = (Mimas_Posix_Shared_Memory*)_mimas_malloc(sizeof(Mimas_Posix_Shared_Memory));
+    if(!memory) {
+        // TODO: Error
+        return NULL;
+    }
+
+    if(!make_object_name(name, memory->name)) {
+        _mimas_free(memory);
+        // TODO: Error
+        return NULL;
+    }
+
+    // O_EXCL makes creation fail if the memory belongs to another export.
+    int const flags = create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR;
+    int fd = shm_open(memory->name, flags, 0600);
+    if(fd < 0 && create && errno == EEXIST && remove_stale_shared_memory(memory->name)) {
+        fd = shm_open(memory->name, flags, 0600);
+    }
+    if(fd < 0) {
+        _mimas_free(memory);
+        return NULL;
+    }
+
+    if(create) {
+        flock(fd, LOCK_EX | LOCK_NB);
+    }
+
+    mimas_bool sized;
+    if(create) {
+        sized = ftruncate(fd, (off_t)size) == 0;
+    } else {
+        struct stat info;
+        sized = fstat(fd, &info) == 0;
+        size = sized ? (mimas_u64)info.st_size : 0;
+    }
+
+    void* const view = sized && size > 0 ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if(view == MAP_FAILED) {
+        close(fd);
+        if(create) {
+            shm_unlink(memory->name);
+        }
+        _mimas_free(memory);
+        // TODO: Error
+        return NULL;
+    }
+
+    if(!create) {
+        close(fd);
+        fd = -1;
+    }
+    memory->size = size;
+    memory->owner = create;
+    memory->lock_fd = fd;
+    *handle = memory;
+    if(mapped_size) {
+        *mapped_size = size;
+    }
+    return view;
+}
+
+void* mimas_platform_create_shared_memory(char const* const name, mimas_u64 const size, void** const handle) {
+    return map_shared_memory(name, size, handle, NULL, mimas_true);
+}
+
+void* mimas_platform_open_shared_memory(char const* const name, void** const handle, mimas_u64* const size) {
+    return map_shared_memory(name, 0, handle, size, mimas_false);
+}
+
+void mimas_platform_close_shared_memory(void* const handle, void* const view) {
+    Mimas_Posix_Shared_Memory* const memory = (Mimas_Posix_Shared_Memory*)handle;
+    munmap(view, memory->size);
+    if(memory->owner) {
+        shm_unlink(memory->name);
+        // Closing the descriptor releases the lock.
+        close(memory->lock_fd);
+    }
+    _mimas_free(memory);
+}
+
+void* mimas_platform_create_named_event(char const* const name) {
+    char object_name[MIMAS_POSIX_OBJECT_NAME_SIZE];
+    if(!make_object_name(name, object_name)) {
+        // TODO: Error
+        return NULL;
+    }
+
+    // Start unsignalled even if a crashed process left the semaphore behind.
+    sem_unlink(object_name);
+    sem_t* const event = sem_open(object_name, O_CREAT, 0600, 0);
+    return event == SEM_FAILED ? NULL : event;
+}
+
+void* mimas_platform_open_named_event(char const* const name) {
+    char object_name[MIMAS_POSIX_OBJECT_NAME_SIZE];
+    if(!make_object_name(name, object_name)) {
+        // TODO: Error
+        return NULL;
+    }
+
+    sem_t* const event = sem_open(object_name, 0);
+    return event == SEM_FAILED ? NULL : event;
+}
+
+void mimas_platform_close_named_event(void* const event) {
+    sem_close((sem_t*)event);
+}
+
+void mimas_platform_signal_named_event(void* const event) {
+    // Approximates an auto-reset event: repeated signals before a wait wake the waiter only once.
+    int value = 0;
+    if(sem_getvalue((sem_t*)event, &value) == 0 && value > 0) {
+        return;
+    }
+    sem_post((sem_t*)event);
+}
+
+mimas_bool mimas_platform_wait_named_event(void* const event, mimas_u32 const timeout_ms) {
+    if(timeout_ms == MIMAS_WAIT_FOREVER) {
+        while(sem_wait((sem_t*)event) != 0) {
+            if(errno != EINTR) {
+                return mimas_false;
+            }
+        }
+        return mimas_true;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if(deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    while(sem_timedwait((sem_t*)event, &deadline) != 0) {
+        if(errno != EINTR) {
+            return mimas_false;
+        }
+    }
+    return mimas_true;
+}
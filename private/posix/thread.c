@@ -0,0 +1,28 @@
+#include <platform.h>
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#else
+#include <pthread.h>
+#endif
+
+mimas_u32 mimas_platform_get_thread_id() {
+#if defined(__linux__)
+    return (mimas_u32)syscall(SYS_gettid);
+#else
+    return (mimas_u32)(mimas_u64)pthread_self();
+#endif
+}
+
+mimas_u32 mimas_platform_get_process_id() {
+    return (mimas_u32)getpid();
+}
+
+void mimas_platform_sleep_ms(mimas_u32 const milliseconds) {
+    struct timespec duration = {milliseconds / 1000, (long)(milliseconds % 1000) * 1000000L};
+    // Resume after signals until the full duration has elapsed.
+    while(nanosleep(&duration, &duration) != 0 && errno == EINTR) {}
+}
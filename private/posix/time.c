@@ -0,0 +1,9 @@
+#include <platform.h>
+
+#include <time.h>
+
+mimas_u64 mimas_platform_get_time_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (mimas_u64)now.tv_sec * 1000000000ULL + (mimas_u64)now.tv_nsec;
+}
@@ -0,0 +1,144 @@
+#include <stats.h>
+#include <atomic.h>
+#include <internal.h>
+#include <platform.h>
+
+#include <string.h>
+
+mimas_i32 volatile _mimas_stats_enabled = mimas_false;
+
+static Mimas_Stats _mimas_stats;
+
+static mimas_u32 histogram_bucket(mimas_u64 const value) {
+    mimas_u32 bucket = 0;
+    for(mimas_u64 v = value; v != 0; v >>= 1) {
+        bucket += 1;
+    }
+    return bucket < MIMAS_HISTOGRAM_BUCKET_COUNT ? bucket : MIMAS_HISTOGRAM_BUCKET_COUNT - 1;
+}
+
+// Mimas_Stats consists only of mimas_u64 fields, therefore we may copy and clear it one field at a time.
+static void load_stats(Mimas_Stats* const dst, Mimas_Stats* const src) {
+    mimas_u64 volatile* const from = (mimas_u64 volatile*)src;
+    mimas_u64* const to = (mimas_u64*)dst;
+    for(mimas_u64 i = 0; i < sizeof(Mimas_Stats) / sizeof(mimas_u64); ++i) {
+        to[i] = _mimas_atomic_load_u64(from + i);
+    }
+}
+
+static void clear_stats(Mimas_Stats* const stats) {
+    mimas_u64 volatile* const fields = (mimas_u64 volatile*)stats;
+    for(mimas_u64 i = 0; i < sizeof(Mimas_Stats) / sizeof(mimas_u64); ++i) {
+        _mimas_atomic_store_u64(fields + i, 0);
+    }
+}
+
+void _mimas_stats_record(Mimas_Histogram* const histogram, mimas_u64 const value) {
+    _mimas_atomic_add_u64(&histogram->count, 1);
+    _mimas_atomic_add_u64(&histogram->sum, value);
+    _mimas_atomic_max_u64(&histogram->max, value);
+    _mimas_atomic_add_u64(&histogram->buckets[histogram_bucket(value)], 1);
+}
+
+mimas_u64 _mimas_stats_begin() {
+    if(!_mimas_stats_enabled) {
+        return 0;
+    }
+
+    return mimas_platform_get_time_ns();
+}
+
+void _mimas_stats_count_allocation() {
+    if(_mimas_stats_enabled) {
+        _mimas_atomic_add_u64(&_mimas_stats.allocations, 1);
+    }
+}
+
+void _mimas_stats_count_deallocation() {
+    if(_mimas_stats_enabled) {
+        _mimas_atomic_add_u64(&_mimas_stats.deallocations, 1);
+    }
+}
+
+void _mimas_stats_end_poll(mimas_u64 const start, mimas_u32 const events) {
+    if(start == 0 || !_mimas_stats_enabled) {
+        return;
+    }
+
+    mimas_u64 const duration = mimas_platform_get_time_ns() - start;
+    _mimas_atomic_add_u64(&_mimas_stats.polls, 1);
+    _mimas_atomic_add_u64(&_mimas_stats.events, events);
+    _mimas_stats_record(&_mimas_stats.events_per_poll, events);
+    _mimas_stats_record(&_mimas_stats.poll_time_ns, duration);
+
+    for(Mimas_Window* window = _mimas_get_mimas_internal()->windows; window; window = window->next) {
+        _mimas_stats_record(&window->stats.events_per_poll, window->poll_events);
+        window->poll_events = 0;
+    }
+}
+
+void _mimas_stats_end_swap(Mimas_Window* const window, mimas_u64 const start) {
+    if(start == 0 || !_mimas_stats_enabled) {
+        return;
+    }
+
+    mimas_u64 const end = mimas_platform_get_time_ns();
+    _mimas_stats_record(&_mimas_stats.swap_time_ns, end - start);
+    _mimas_stats_record(&window->stats.swap_time_ns, end - start);
+
+    // The event loop may start a new measurement while we clear this one, in which case we report it after the next swap.
+    mimas_u64 const input = _mimas_atomic_load_u64(&window->unpresented_input_ns);
+    if(input != 0 && _mimas_atomic_cas_u64(&window->unpresented_input_ns, input, 0)) {
+        _mimas_stats_record(&_mimas_stats.input_to_present_ns, end - input);
+        _mimas_stats_record(&window->stats.input_to_present_ns, end - input);
+    }
+}
+
+void _mimas_stats_end_callback(Mimas_Window* const window, Mimas_Callback_Type const type, mimas_u64 const start) {
+    if(start == 0 || !_mimas_stats_enabled) {
+        return;
+    }
+
+    mimas_u64 const duration = mimas_platform_get_time_ns() - start;
+    _mimas_stats_record(&_mimas_stats.callback_time_ns[type], duration);
+    _mimas_stats_record(&window->stats.callback_time_ns[type], duration);
+}
+
+void _mimas_stats_count_window_event(Mimas_Window* const window) {
+    if(_mimas_stats_enabled) {
+        window->poll_events += 1;
+        _mimas_atomic_add_u64(&window->stats.events, 1);
+    }
+}
+
+void _mimas_stats_count_input(Mimas_Window* const window, mimas_u64 const timestamp_ns) {
+    if(_mimas_stats_enabled && _mimas_atomic_load_u64(&window->unpresented_input_ns) == 0) {
+        _mimas_atomic_cas_u64(&window->unpresented_input_ns, 0, timestamp_ns ? timestamp_ns : mimas_platform_get_time_ns());
+    }
+}
+
+void mimas_set_stats_enabled(mimas_bool const enabled) {
+    _mimas_atomic_store_i32(&_mimas_stats_enabled, enabled != mimas_false);
+}
+
+mimas_bool mimas_get_stats_enabled() {
+    return _mimas_atomic_load_i32(&_mimas_stats_enabled);
+}
+
+void mimas_get_stats(Mimas_Stats* const stats) {
+    load_stats(stats, &_mimas_stats);
+}
+
+void mimas_get_window_stats(Mimas_Window* const window, Mimas_Stats* const stats) {
+    load_stats(stats, &window->stats);
+}
+
+void mimas_reset_stats() {
+    clear_stats(&_mimas_stats);
+    if(_mimas_is_initialized()) {
+        for(Mimas_Window* window = _mimas_get_mimas_internal()->windows; window; window = window->next) {
+            clear_stats(&window->stats);
+            _mimas_atomic_store_u64(&window->unpresented_input_ns, 0);
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef MIMAS_STATS_H_INCLUDE
+#define MIMAS_STATS_H_INCLUDE
+
+#include <mimas/mimas.h>
+#include <internal.h>
+#include <utils.h>
+
+extern mimas_i32 volatile _mimas_stats_enabled;
+
+void _mimas_stats_record(Mimas_Histogram* histogram, mimas_u64 value);
+void _mimas_stats_count_allocation();
+void _mimas_stats_count_deallocation();
+void _mimas_stats_end_poll(mimas_u64 start, mimas_u32 events);
+void _mimas_stats_end_swap(Mimas_Window* window, mimas_u64 start);
+void _mimas_stats_end_callback(Mimas_Window* window, Mimas_Callback_Type type, mimas_u64 start);
+void _mimas_stats_count_window_event(Mimas_Window* window);
+// Starts the input_to_present_ns measurement of an input event of window unless an older event is still waiting for a swap.
+// timestamp_ns is the time the event occurred or 0 if it has just been received.
+void _mimas_stats_count_input(Mimas_Window* window, mimas_u64 timestamp_ns);
+
+// Returns the start timestamp of a measured section or 0 if stats are disabled.
+mimas_u64 _mimas_stats_begin();
+
+#endif // !MIMAS_STATS_H_INCLUDE
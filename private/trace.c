@@ -0,0 +1,182 @@
+#include <trace.h>
+#include <instrument.h>
+#include <atomic.h>
+#include <internal.h>
+#include <platform.h>
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct Mimas_Trace_Event {
+    mimas_u64 timestamp;
+    char const* name;
+    mimas_u32 arg;
+    mimas_u8 phase;
+    mimas_bool has_arg;
+} Mimas_Trace_Event;
+
+// Single producer ring buffer owned by one thread.
+typedef struct Mimas_Trace_Buffer {
+    struct Mimas_Trace_Buffer* next;
+    mimas_u32 thread_id;
+    mimas_u32 capacity;
+    // Written by the owning thread when it resets the buffer. Readers compare it before and after copying events.
+    mimas_u64 volatile generation;
+    // Total number of events written since the buffer was last reset.
+    mimas_u64 volatile head;
+    Mimas_Trace_Event events[];
+} Mimas_Trace_Buffer;
+
+mimas_i32 volatile _mimas_trace_enabled = mimas_false;
+
+char const* const _mimas_callback_names[MIMAS_CALLBACK_TYPE_COUNT] = {
+    [MIMAS_CALLBACK_WINDOW_ACTIVATE] = "window_activate_callback",
+    [MIMAS_CALLBACK_CURSOR_POS] = "cursor_pos_callback",
+    [MIMAS_CALLBACK_MOUSE_BUTTON] = "mouse_button_callback",
+    [MIMAS_CALLBACK_KEY] = "key_callback",
+    [MIMAS_CALLBACK_HITTEST] = "hittest",
+    [MIMAS_CALLBACK_TEXT] = "text_callback",
+    [MIMAS_CALLBACK_RESIZE] = "resize_callback",
+    [MIMAS_CALLBACK_CONTENT_SCALE] = "content_scale_callback",
+    [MIMAS_CALLBACK_VISIBILITY] = "visibility_callback",
+    [MIMAS_CALLBACK_REDRAW] = "redraw_callback",
+};
+
+static mimas_u32 volatile trace_capacity = 0;
+// Incremented every time tracing is enabled. Buffers of older generations are reset before they are written to.
+static mimas_u64 volatile trace_generation = 0;
+static void* volatile trace_buffers = NULL;
+static MIMAS_THREAD_LOCAL Mimas_Trace_Buffer* thread_buffer = NULL;
+
+static Mimas_Trace_Buffer* create_thread_buffer(mimas_u32 const capacity) {
+    Mimas_Trace_Buffer* const buffer = (Mimas_Trace_Buffer*)_mimas_malloc(sizeof(Mimas_Trace_Buffer) + sizeof(Mimas_Trace_Event) * capacity);
+    if(!buffer) {
+        return NULL;
+    }
+
+    buffer->thread_id = mimas_platform_get_thread_id();
+    buffer->capacity = capacity;
+    buffer->generation = _mimas_atomic_load_u64(&trace_generation);
+    buffer->head = 0;
+
+    Mimas_Trace_Buffer* head;
+    do {
+        head = (Mimas_Trace_Buffer*)_mimas_atomic_load_ptr(&trace_buffers);
+        buffer->next = head;
+    } while(!_mimas_atomic_cas_ptr(&trace_buffers, head, buffer));
+    return buffer;
+}
+
+void _mimas_trace_record(char const* const name, mimas_u8 const phase, mimas_bool const has_arg, mimas_u32 const arg) {
+    Mimas_Trace_Buffer* buffer = thread_buffer;
+    mimas_u64 const generation = _mimas_atomic_load_u64(&trace_generation);
+    if(!buffer || buffer->capacity < trace_capacity) {
+        buffer = create_thread_buffer(trace_capacity);
+        if(!buffer) {
+            return;
+        }
+        thread_buffer = buffer;
+    } else if(buffer->generation != generation) {
+        // Publish the new generation before any event of it, so that a reader copying the old events notices the reset.
+        _mimas_atomic_store_u64(&buffer->generation, generation);
+        _mimas_atomic_fence();
+        _mimas_atomic_store_release_u64(&buffer->head, 0);
+    }
+
+    mimas_u64 const head = buffer->head;
+    Mimas_Trace_Event* const event = &buffer->events[head & (buffer->capacity - 1)];
+    event->timestamp = mimas_platform_get_time_ns();
+    event->name = name;
+    event->arg = arg;
+    event->phase = phase;
+    event->has_arg = has_arg;
+    _mimas_atomic_store_release_u64(&buffer->head, head + 1);
+}
+
+void mimas_enable_tracing(mimas_u32 const events_per_thread) {
+    mimas_u32 capacity = 1;
+    while(capacity < events_per_thread && capacity < 0x80000000u) {
+        capacity <<= 1;
+    }
+
+    trace_capacity = capacity;
+    _mimas_atomic_add_u64(&trace_generation, 1);
+    _mimas_atomic_store_i32(&_mimas_trace_enabled, mimas_true);
+}
+
+void mimas_disable_tracing() {
+    _mimas_atomic_store_i32(&_mimas_trace_enabled, mimas_false);
+}
+
+static void write_event(FILE* const file, mimas_bool const first, mimas_u32 const pid, mimas_u32 const tid, Mimas_Trace_Event const* const event) {
+    fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu.%03llu,\"pid\":%u,\"tid\":%u", first ? "" : ",", event->name, event->phase,
+            event->timestamp / 1000, event->timestamp % 1000, pid, tid);
+    if(event->has_arg) {
+        fprintf(file, ",\"args\":{\"arg\":%u}", event->arg);
+    }
+    fputc('}', file);
+}
+
+mimas_bool mimas_write_trace(char const* const path) {
+    FILE* const file = fopen(path, "w");
+    if(!file) {
+        return mimas_false;
+    }
+
+    mimas_u32 const pid = mimas_platform_get_process_id();
+    mimas_u64 const generation = _mimas_atomic_load_u64(&trace_generation);
+    mimas_bool first = mimas_true;
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+    for(Mimas_Trace_Buffer* buffer = (Mimas_Trace_Buffer*)_mimas_atomic_load_ptr(&trace_buffers); buffer; buffer = buffer->next) {
+        if(_mimas_atomic_load_u64(&buffer->generation) != generation) {
+            continue;
+        }
+
+        // Copy the events out of the ring first and then discard any that the owning thread
+        // may have overwritten while we were copying.
+        mimas_u64 const end = _mimas_atomic_load_acquire_u64(&buffer->head);
+        mimas_u64 begin = end > buffer->capacity ? end - buffer->capacity : 0;
+        Mimas_Trace_Event* const events = (Mimas_Trace_Event*)_mimas_malloc(sizeof(Mimas_Trace_Event) * (end - begin + 1));
+        if(!events) {
+            continue;
+        }
+
+        for(mimas_u64 i = begin; i < end; ++i) {
+            events[i - begin] = buffer->events[i & (buffer->capacity - 1)];
+        }
+
+        // A reset may have been followed by more events than we copied, so only the generation reliably detects it.
+        _mimas_atomic_fence();
+        if(_mimas_atomic_load_u64(&buffer->generation) != generation) {
+            _mimas_free(events);
+            continue;
+        }
+
+        // The owning thread may be in the middle of writing event head, which occupies the slot of event head - capacity.
+        mimas_u64 const head = _mimas_atomic_load_acquire_u64(&buffer->head);
+        mimas_u64 const first_valid = head >= buffer->capacity ? head - buffer->capacity + 1 : 0;
+        mimas_u64 const skip = first_valid > begin ? first_valid - begin : 0;
+
+        // Drop end events whose begin events have been overwritten so that the spans stay balanced.
+        mimas_u64 depth = 0;
+        for(mimas_u64 i = skip; i < end - begin; ++i) {
+            Mimas_Trace_Event const* const event = &events[i];
+            if(event->phase == 'B') {
+                depth += 1;
+            } else if(depth > 0) {
+                depth -= 1;
+            } else {
+                continue;
+            }
+
+            write_event(file, first, pid, buffer->thread_id, event);
+            first = mimas_false;
+        }
+
+        _mimas_free(events);
+    }
+    fputs("\n]}\n", file);
+
+    mimas_bool const res = !ferror(file);
+    return fclose(file) == 0 && res;
+}
@@ -0,0 +1,30 @@
+#ifndef MIMAS_TRACE_H_INCLUDE
+#define MIMAS_TRACE_H_INCLUDE
+
+#include <mimas/mimas.h>
+#include <utils.h>
+
+extern mimas_i32 volatile _mimas_trace_enabled;
+
+// name must be a string with static storage duration.
+void _mimas_trace_record(char const* name, mimas_u8 phase, mimas_bool has_arg, mimas_u32 arg);
+
+MIMAS_INLINE void _mimas_trace_begin(char const* const name) {
+    if(_mimas_trace_enabled) {
+        _mimas_trace_record(name, 'B', mimas_false, 0);
+    }
+}
+
+MIMAS_INLINE void _mimas_trace_begin_with_arg(char const* const name, mimas_u32 const arg) {
+    if(_mimas_trace_enabled) {
+        _mimas_trace_record(name, 'B', mimas_true, arg);
+    }
+}
+
+MIMAS_INLINE void _mimas_trace_end(char const* const name) {
+    if(_mimas_trace_enabled) {
+        _mimas_trace_record(name, 'E', mimas_false, 0);
+    }
+}
+
+#endif // !MIMAS_TRACE_H_INCLUDE
@@ -2,5 +2,15 @@
 #define MIMAS_UTILS_H_INCLUDE
 
 #define ARRAY_SIZE(arr) (sizeof(arr) / sizeof(arr[0]))
+// Silences warnings about parameters that a backend does not need.
+#define MIMAS_UNUSED(x) (void)(x)
+
+#if defined(_MSC_VER)
+    #define MIMAS_INLINE static __forceinline
+    #define MIMAS_THREAD_LOCAL __declspec(thread)
+#else
+    #define MIMAS_INLINE static inline
+    #define MIMAS_THREAD_LOCAL __thread
+#endif
 
 #endif // !MIMAS_UTILS_H_INCLUDE
@@ -0,0 +1,303 @@
+#include <platform.h>
+#include <win/platform.h>
+#include <internal.h>
+
+#include <string.h>
+
+#define MIMAS_CLIPBOARD_INITIAL_CAPACITY (64 * 1024)
+#define MIMAS_CLIPBOARD_CHUNK_SIZE (1024 * 1024)
+#define MIMAS_CLIPBOARD_TEXT_CHUNK_SIZE (32 * 1024)
+
+// typedef in mimas/mimas.h
+struct Mimas_Clipboard_Sink {
+    HGLOBAL memory;
+    mimas_u64 size;
+    mimas_u64 capacity;
+    mimas_bool failed;
+};
+
+static Mimas_Win_Clipboard* get_clipboard() {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    return &platform->clipboard;
+}
+
+static HWND get_clipboard_window() {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    return platform->helper_window;
+}
+
+static mimas_bool is_text_mime_type(char const* const mime_type) {
+    return strncmp(mime_type, "text/plain", 10) == 0;
+}
+
+// Returns the native clipboard format for mime_type or 0 if the format could not be registered.
+static UINT get_clipboard_format(char const* const mime_type) {
+    if(is_text_mime_type(mime_type)) {
+        return CF_UNICODETEXT;
+    }
+
+    int const wmime_type_size = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, mime_type, -1, NULL, 0);
+    if(wmime_type_size <= 0) {
+        return 0;
+    }
+
+    wchar_t* const wmime_type = (wchar_t*)_mimas_malloc(sizeof(wchar_t) * wmime_type_size);
+    if(!wmime_type) {
+        return 0;
+    }
+    MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, mime_type, -1, wmime_type, wmime_type_size);
+    UINT const format = RegisterClipboardFormatW(wmime_type);
+    _mimas_free(wmime_type);
+    return format;
+}
+
+static HGLOBAL utf8_to_global_utf16(HGLOBAL const utf8, mimas_u64 const size) {
+    char const* const text = (char const*)GlobalLock(utf8);
+    int const length = size > 0 ? MultiByteToWideChar(CP_UTF8, 0, text, (int)size, NULL, 0) : 0;
+    HGLOBAL const memory = GlobalAlloc(GMEM_MOVEABLE, sizeof(wchar_t) * (length + 1));
+    if(memory) {
+        wchar_t* const wtext = (wchar_t*)GlobalLock(memory);
+        if(length > 0) {
+            MultiByteToWideChar(CP_UTF8, 0, text, (int)size, wtext, length);
+        }
+        wtext[length] = L'\0';
+        GlobalUnlock(memory);
+    }
+    GlobalUnlock(utf8);
+    return memory;
+}
+
+// Invokes the provide callback and returns the data in the native format or NULL on failure.
+static HGLOBAL render_format(Mimas_Win_Clipboard* const clipboard, mimas_u32 const index) {
+    char const* const mime_type = clipboard->mime_types[index];
+    mimas_bool const text = is_text_mime_type(mime_type);
+    Mimas_Clipboard_Sink sink = {
+        .memory = GlobalAlloc(GMEM_MOVEABLE, MIMAS_CLIPBOARD_INITIAL_CAPACITY),
+        .size = 0,
+        .capacity = MIMAS_CLIPBOARD_INITIAL_CAPACITY,
+        .failed = mimas_false,
+    };
+    if(!sink.memory) {
+        return NULL;
+    }
+
+    clipboard->offer.provide(mime_type, &sink, clipboard->offer.user_data);
+    if(sink.failed) {
+        GlobalFree(sink.memory);
+        return NULL;
+    }
+
+    if(text) {
+        HGLOBAL const memory = utf8_to_global_utf16(sink.memory, sink.size);
+        GlobalFree(sink.memory);
+        return memory;
+    } else {
+        // Other applications read the raw bytes and take their size from GlobalSize, so we trim the spare capacity.
+        // GlobalSize may still round up by a few bytes, which formats on the clipboard have to tolerate anyway.
+        if(sink.size == 0) {
+            GlobalFree(sink.memory);
+            return NULL;
+        }
+
+        HGLOBAL const memory = GlobalReAlloc(sink.memory, (SIZE_T)sink.size, GMEM_MOVEABLE);
+        if(!memory) {
+            // Publishing the untrimmed buffer would hand out uninitialized bytes.
+            GlobalFree(sink.memory);
+            return NULL;
+        }
+        return memory;
+    }
+}
+
+void mimas_win_render_clipboard_format(UINT const format) {
+    Mimas_Win_Clipboard* const clipboard = get_clipboard();
+    for(mimas_u32 i = 0; i < clipboard->offer.mime_type_count; ++i) {
+        if(clipboard->formats[i] == format) {
+            HGLOBAL const memory = render_format(clipboard, i);
+            if(memory) {
+                SetClipboardData(format, memory);
+            }
+            return;
+        }
+    }
+}
+
+void mimas_win_render_all_clipboard_formats() {
+    Mimas_Win_Clipboard* const clipboard = get_clipboard();
+    HWND const hwnd = get_clipboard_window();
+    if(!OpenClipboard(hwnd)) {
+        return;
+    }
+
+    if(GetClipboardOwner() == hwnd) {
+        for(mimas_u32 i = 0; i < clipboard->offer.mime_type_count; ++i) {
+            HGLOBAL const memory = render_format(clipboard, i);
+            if(memory) {
+                SetClipboardData(clipboard->formats[i], memory);
+            }
+        }
+    }
+
+    CloseClipboard();
+}
+
+void mimas_win_release_clipboard() {
+    Mimas_Win_Clipboard* const clipboard = get_clipboard();
+    if(clipboard->offer.release) {
+        clipboard->offer.release(clipboard->offer.user_data);
+    }
+
+    for(mimas_u32 i = 0; i < clipboard->offer.mime_type_count; ++i) {
+        _mimas_free(clipboard->mime_types[i]);
+    }
+    _mimas_free(clipboard->mime_types);
+    _mimas_free(clipboard->formats);
+    memset(clipboard, 0, sizeof(Mimas_Win_Clipboard));
+}
+
+mimas_bool mimas_win_platform_set_clipboard(Mimas_Clipboard_Offer const offer) {
+    HWND const hwnd = get_clipboard_window();
+    if(!OpenClipboard(hwnd)) {
+        return mimas_false;
+    }
+
+    // Releases our previous offer through WM_DESTROYCLIPBOARD if we own the clipboard.
+    EmptyClipboard();
+
+    // Releasing an offer clears it, so this does nothing if WM_DESTROYCLIPBOARD has released it already.
+    Mimas_Win_Clipboard* const clipboard = get_clipboard();
+    mimas_win_release_clipboard();
+
+    if(offer.mime_type_count > 0) {
+        clipboard->mime_types = (char**)_mimas_malloc(sizeof(char*) * offer.mime_type_count);
+        clipboard->formats = (UINT*)_mimas_malloc(sizeof(UINT) * offer.mime_type_count);
+    }
+    if(offer.mime_type_count > 0 && (!clipboard->mime_types || !clipboard->formats)) {
+        _mimas_free(clipboard->mime_types);
+        _mimas_free(clipboard->formats);
+        clipboard->mime_types = NULL;
+        clipboard->formats = NULL;
+        CloseClipboard();
+        return mimas_false;
+    }
+
+    clipboard->offer = offer;
+    clipboard->offer.mime_types = NULL;
+    clipboard->offer.mime_type_count = 0;
+    for(mimas_u32 i = 0; i < offer.mime_type_count; ++i) {
+        size_t const length = strlen(offer.mime_types[i]);
+        char* const mime_type = (char*)_mimas_malloc(length + 1);
+        if(!mime_type) {
+            // The offer is already ours and will be released, so we keep the types copied so far.
+            break;
+        }
+
+        memcpy(mime_type, offer.mime_types[i], length + 1);
+        clipboard->mime_types[i] = mime_type;
+        clipboard->offer.mime_type_count = i + 1;
+        clipboard->formats[i] = get_clipboard_format(offer.mime_types[i]);
+        // Delayed rendering. The data is requested through WM_RENDERFORMAT once someone pastes it.
+        if(clipboard->formats[i]) {
+            SetClipboardData(clipboard->formats[i], NULL);
+        }
+    }
+
+    CloseClipboard();
+    return mimas_true;
+}
+
+void mimas_win_platform_write_clipboard_data(Mimas_Clipboard_Sink* const sink, void const* const data, mimas_u64 const size) {
+    if(sink->failed || size == 0) {
+        return;
+    }
+
+    mimas_u64 const required = sink->size + size;
+    if(required > sink->capacity) {
+        mimas_u64 capacity = sink->capacity * 2;
+        if(capacity < required) {
+            capacity = required;
+        }
+
+        HGLOBAL const memory = (SIZE_T)capacity == capacity ? GlobalReAlloc(sink->memory, (SIZE_T)capacity, GMEM_MOVEABLE) : NULL;
+        if(!memory) {
+            sink->failed = mimas_true;
+            return;
+        }
+        sink->memory = memory;
+        sink->capacity = capacity;
+    }
+
+    mimas_u8* const dst = (mimas_u8*)GlobalLock(sink->memory);
+    memcpy(dst + sink->size, data, size);
+    GlobalUnlock(sink->memory);
+    sink->size = required;
+}
+
+static mimas_bool receive_text(wchar_t const* const wtext, mimas_u64 const max_length, mimas_clipboard_receive_callback const callback, void* const user_data) {
+    mimas_u64 length = 0;
+    while(length < max_length && wtext[length] != L'\0') {
+        length += 1;
+    }
+
+    // Every UTF-16 code unit encodes to at most 3 UTF-8 bytes.
+    char* const buffer = (char*)_mimas_malloc(3 * MIMAS_CLIPBOARD_TEXT_CHUNK_SIZE);
+    if(!buffer) {
+        return mimas_false;
+    }
+
+    mimas_bool res = mimas_true;
+    for(mimas_u64 offset = 0; offset < length && res;) {
+        mimas_u64 chunk = length - offset < MIMAS_CLIPBOARD_TEXT_CHUNK_SIZE ? length - offset : MIMAS_CLIPBOARD_TEXT_CHUNK_SIZE;
+        // Do not split surrogate pairs between chunks.
+        if(offset + chunk < length && IS_HIGH_SURROGATE(wtext[offset + chunk - 1])) {
+            chunk -= 1;
+        }
+
+        int const size = WideCharToMultiByte(CP_UTF8, 0, wtext + offset, (int)chunk, buffer, 3 * MIMAS_CLIPBOARD_TEXT_CHUNK_SIZE, NULL, NULL);
+        res = size > 0 && callback(buffer, size, user_data);
+        offset += chunk;
+    }
+    _mimas_free(buffer);
+    return res;
+}
+
+static mimas_bool receive_binary(mimas_u8 const* const data, mimas_u64 const size, mimas_clipboard_receive_callback const callback, void* const user_data) {
+    // Hand out chunks of the native clipboard memory without copying.
+    for(mimas_u64 offset = 0; offset < size; offset += MIMAS_CLIPBOARD_CHUNK_SIZE) {
+        mimas_u64 const chunk = size - offset < MIMAS_CLIPBOARD_CHUNK_SIZE ? size - offset : MIMAS_CLIPBOARD_CHUNK_SIZE;
+        if(!callback(data + offset, chunk, user_data)) {
+            return mimas_false;
+        }
+    }
+    return mimas_true;
+}
+
+mimas_bool mimas_win_platform_get_clipboard(char const* const mime_type, mimas_clipboard_receive_callback const callback, void* const user_data) {
+    UINT const format = get_clipboard_format(mime_type);
+    if(!format || !OpenClipboard(get_clipboard_window())) {
+        return mimas_false;
+    }
+
+    mimas_bool res = mimas_false;
+    HANDLE const memory = GetClipboardData(format);
+    if(memory) {
+        void const* const data = GlobalLock(memory);
+        if(data) {
+            mimas_u64 const size = GlobalSize(memory);
+            if(format == CF_UNICODETEXT) {
+                res = receive_text((wchar_t const*)data, size / sizeof(wchar_t), callback, user_data);
+            } else {
+                res = receive_binary((mimas_u8 const*)data, size, callback, user_data);
+            }
+            GlobalUnlock(memory);
+        }
+    }
+
+    CloseClipboard();
+    return res;
+}
+
+mimas_bool mimas_win_platform_has_clipboard_data(char const* const mime_type) {
+    UINT const format = get_clipboard_format(mime_type);
+    return format && IsClipboardFormatAvailable(format);
+}
@@ -0,0 +1,77 @@
+#include <win/platform.h>
+#include <internal.h>
+
+#include <string.h>
+
+#define MIMAS_DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2 ((HANDLE)-4)
+#define MIMAS_PROCESS_PER_MONITOR_DPI_AWARE 2
+#define MIMAS_MDT_EFFECTIVE_DPI 0
+
+static Mimas_Win_DPI* get_dpi() {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    return &platform->dpi;
+}
+
+void mimas_win_init_dpi(Mimas_Win_Platform* const platform) {
+    Mimas_Win_DPI* const dpi = &platform->dpi;
+    HMODULE const user32 = GetModuleHandleW(L"user32.dll");
+    dpi->shcore_module = LoadLibraryW(L"shcore.dll");
+
+    dpi->GetDpiForWindow = (PFN_GetDpiForWindow)GetProcAddress(user32, "GetDpiForWindow");
+    dpi->AdjustWindowRectExForDpi = (PFN_AdjustWindowRectExForDpi)GetProcAddress(user32, "AdjustWindowRectExForDpi");
+    if(dpi->shcore_module) {
+        dpi->GetDpiForMonitor = (PFN_GetDpiForMonitor)GetProcAddress(dpi->shcore_module, "GetDpiForMonitor");
+    }
+
+    // Use the best awareness the system supports so that the compositor never scales our framebuffer.
+    PFN_SetProcessDpiAwarenessContext const SetProcessDpiAwarenessContext = (PFN_SetProcessDpiAwarenessContext)GetProcAddress(user32, "SetProcessDpiAwarenessContext");
+    if(SetProcessDpiAwarenessContext && SetProcessDpiAwarenessContext(MIMAS_DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2)) {
+        return;
+    }
+
+    PFN_SetProcessDpiAwareness const SetProcessDpiAwareness = dpi->shcore_module ? (PFN_SetProcessDpiAwareness)GetProcAddress(dpi->shcore_module, "SetProcessDpiAwareness") : NULL;
+    if(SetProcessDpiAwareness && SUCCEEDED(SetProcessDpiAwareness(MIMAS_PROCESS_PER_MONITOR_DPI_AWARE))) {
+        return;
+    }
+
+    SetProcessDPIAware();
+}
+
+void mimas_win_terminate_dpi(Mimas_Win_Platform* const platform) {
+    if(platform->dpi.shcore_module) {
+        FreeLibrary(platform->dpi.shcore_module);
+    }
+    memset(&platform->dpi, 0, sizeof(Mimas_Win_DPI));
+}
+
+UINT mimas_win_get_monitor_dpi(HMONITOR const monitor) {
+    Mimas_Win_DPI* const dpi = get_dpi();
+    UINT dpi_x;
+    UINT dpi_y;
+    if(dpi->GetDpiForMonitor && SUCCEEDED(dpi->GetDpiForMonitor(monitor, MIMAS_MDT_EFFECTIVE_DPI, &dpi_x, &dpi_y))) {
+        return dpi_x;
+    }
+
+    HDC const hdc = GetDC(NULL);
+    UINT const system_dpi = GetDeviceCaps(hdc, LOGPIXELSX);
+    ReleaseDC(NULL, hdc);
+    return system_dpi;
+}
+
+UINT mimas_win_get_window_dpi(HWND const hwnd) {
+    Mimas_Win_DPI* const dpi = get_dpi();
+    if(dpi->GetDpiForWindow) {
+        return dpi->GetDpiForWindow(hwnd);
+    }
+
+    return mimas_win_get_monitor_dpi(MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST));
+}
+
+void mimas_win_adjust_window_rect(RECT* const rect, DWORD const style, DWORD const ex_style, UINT const window_dpi) {
+    Mimas_Win_DPI* const dpi = get_dpi();
+    if(dpi->AdjustWindowRectExForDpi) {
+        dpi->AdjustWindowRectExForDpi(rect, style, FALSE, ex_style, window_dpi);
+    } else {
+        AdjustWindowRectEx(rect, style, FALSE, ex_style);
+    }
+}
@@ -0,0 +1,220 @@
+#include <platform.h>
+#include <win/platform.h>
+#include <internal.h>
+#include <atomic.h>
+
+#include <mmsystem.h>
+#include <string.h>
+
+#define XINPUT_GAMEPAD_DPAD_UP          0x0001
+#define XINPUT_GAMEPAD_DPAD_DOWN        0x0002
+#define XINPUT_GAMEPAD_DPAD_LEFT        0x0004
+#define XINPUT_GAMEPAD_DPAD_RIGHT       0x0008
+#define XINPUT_GAMEPAD_START            0x0010
+#define XINPUT_GAMEPAD_BACK             0x0020
+#define XINPUT_GAMEPAD_LEFT_THUMB       0x0040
+#define XINPUT_GAMEPAD_RIGHT_THUMB      0x0080
+#define XINPUT_GAMEPAD_LEFT_SHOULDER    0x0100
+#define XINPUT_GAMEPAD_RIGHT_SHOULDER   0x0200
+#define XINPUT_GAMEPAD_A                0x1000
+#define XINPUT_GAMEPAD_B                0x2000
+#define XINPUT_GAMEPAD_X                0x4000
+#define XINPUT_GAMEPAD_Y                0x8000
+
+typedef struct XINPUT_GAMEPAD {
+    WORD wButtons;
+    BYTE bLeftTrigger;
+    BYTE bRightTrigger;
+    short sThumbLX;
+    short sThumbLY;
+    short sThumbRX;
+    short sThumbRY;
+} XINPUT_GAMEPAD;
+
+typedef struct XINPUT_STATE {
+    DWORD dwPacketNumber;
+    XINPUT_GAMEPAD Gamepad;
+} XINPUT_STATE;
+
+typedef DWORD (WINAPI* PFN_XInputGetState)(DWORD, XINPUT_STATE*);
+
+// Connected gamepads are sampled every millisecond which matches the highest rate XInput devices report at.
+#define MIMAS_GAMEPAD_POLL_INTERVAL_MS 1
+// Probing disconnected slots is expensive in XInput, therefore we look for newly connected gamepads less often.
+#define MIMAS_GAMEPAD_HOTPLUG_INTERVAL_NS 500000000ULL
+
+static Mimas_Win_Gamepads* get_gamepads() {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    return &platform->gamepads;
+}
+
+static float normalize_thumb(short const value) {
+    return value < 0 ? value / 32768.0f : value / 32767.0f;
+}
+
+static void translate_state(XINPUT_STATE const* const xstate, Mimas_Gamepad_State* const state) {
+    WORD const buttons = xstate->Gamepad.wButtons;
+    state->connected = mimas_true;
+    state->packet = xstate->dwPacketNumber;
+    state->axes[MIMAS_GAMEPAD_AXIS_LEFT_X] = normalize_thumb(xstate->Gamepad.sThumbLX);
+    state->axes[MIMAS_GAMEPAD_AXIS_LEFT_Y] = normalize_thumb(xstate->Gamepad.sThumbLY);
+    state->axes[MIMAS_GAMEPAD_AXIS_RIGHT_X] = normalize_thumb(xstate->Gamepad.sThumbRX);
+    state->axes[MIMAS_GAMEPAD_AXIS_RIGHT_Y] = normalize_thumb(xstate->Gamepad.sThumbRY);
+    state->axes[MIMAS_GAMEPAD_AXIS_LEFT_TRIGGER] = xstate->Gamepad.bLeftTrigger / 255.0f;
+    state->axes[MIMAS_GAMEPAD_AXIS_RIGHT_TRIGGER] = xstate->Gamepad.bRightTrigger / 255.0f;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_A] = (buttons & XINPUT_GAMEPAD_A) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_B] = (buttons & XINPUT_GAMEPAD_B) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_X] = (buttons & XINPUT_GAMEPAD_X) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_Y] = (buttons & XINPUT_GAMEPAD_Y) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_LEFT_BUMPER] = (buttons & XINPUT_GAMEPAD_LEFT_SHOULDER) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_RIGHT_BUMPER] = (buttons & XINPUT_GAMEPAD_RIGHT_SHOULDER) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_BACK] = (buttons & XINPUT_GAMEPAD_BACK) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_START] = (buttons & XINPUT_GAMEPAD_START) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_LEFT_THUMB] = (buttons & XINPUT_GAMEPAD_LEFT_THUMB) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_RIGHT_THUMB] = (buttons & XINPUT_GAMEPAD_RIGHT_THUMB) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_DPAD_UP] = (buttons & XINPUT_GAMEPAD_DPAD_UP) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_DPAD_DOWN] = (buttons & XINPUT_GAMEPAD_DPAD_DOWN) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_DPAD_LEFT] = (buttons & XINPUT_GAMEPAD_DPAD_LEFT) != 0;
+    state->buttons[MIMAS_GAMEPAD_BUTTON_DPAD_RIGHT] = (buttons & XINPUT_GAMEPAD_DPAD_RIGHT) != 0;
+}
+
+// Seqlock write. The input thread is the only writer.
+static void publish_state(Mimas_Win_Gamepad* const gamepad, Mimas_Gamepad_State const* const state) {
+    mimas_u64 const sequence = gamepad->sequence;
+    _mimas_atomic_store_u64(&gamepad->sequence, sequence + 1);
+    _mimas_atomic_fence();
+    gamepad->state = *state;
+    _mimas_atomic_fence();
+    _mimas_atomic_store_u64(&gamepad->sequence, sequence + 2);
+}
+
+static DWORD WINAPI gamepad_thread(LPVOID const param) {
+    Mimas_Win_Gamepads* const gamepads = (Mimas_Win_Gamepads*)param;
+    PFN_XInputGetState const XInputGetState = (PFN_XInputGetState)gamepads->get_state;
+    mimas_u64 last_hotplug_check = 0;
+    // Sleep(1) lasts a whole timer tick, 15.6 ms by default, which would delay input by up to a frame.
+    // Without a high resolution timer we raise the system timer resolution while the thread runs instead.
+    HANDLE const timer = mimas_win_create_high_resolution_timer();
+    if(!timer) {
+        timeBeginPeriod(1);
+    }
+
+    while(_mimas_atomic_load_i32(&gamepads->running)) {
+        mimas_u64 const now = mimas_platform_get_time_ns();
+        mimas_bool const check_hotplug = now - last_hotplug_check >= MIMAS_GAMEPAD_HOTPLUG_INTERVAL_NS;
+        if(check_hotplug) {
+            last_hotplug_check = now;
+        }
+
+        mimas_bool changed = mimas_false;
+        for(DWORD i = 0; i < MIMAS_MAX_GAMEPADS; ++i) {
+            Mimas_Win_Gamepad* const gamepad = &gamepads->gamepads[i];
+            mimas_bool const connected = gamepad->state.connected;
+            if(!connected && !check_hotplug) {
+                continue;
+            }
+
+            XINPUT_STATE xstate;
+            if(XInputGetState(i, &xstate) == ERROR_SUCCESS) {
+                if(!connected || xstate.dwPacketNumber != gamepad->state.packet) {
+                    Mimas_Gamepad_State state;
+                    memset(&state, 0, sizeof(Mimas_Gamepad_State));
+                    translate_state(&xstate, &state);
+                    state.timestamp_ns = now;
+                    publish_state(gamepad, &state);
+                    changed = mimas_true;
+                }
+            } else if(connected) {
+                Mimas_Gamepad_State state;
+                memset(&state, 0, sizeof(Mimas_Gamepad_State));
+                state.timestamp_ns = now;
+                publish_state(gamepad, &state);
+                changed = mimas_true;
+            }
+        }
+
+        if(changed) {
+            SetEvent(gamepads->event);
+        }
+
+        if(timer && mimas_win_set_timer(timer, MIMAS_GAMEPAD_POLL_INTERVAL_MS * 1000000ULL)) {
+            WaitForSingleObject(timer, INFINITE);
+        } else {
+            Sleep(MIMAS_GAMEPAD_POLL_INTERVAL_MS);
+        }
+    }
+
+    if(timer) {
+        CloseHandle(timer);
+    } else {
+        timeEndPeriod(1);
+    }
+    return 0;
+}
+
+mimas_bool mimas_win_platform_set_gamepad_input_enabled(mimas_bool const enabled) {
+    Mimas_Win_Gamepads* const gamepads = get_gamepads();
+    if(enabled && !gamepads->thread) {
+        wchar_t const* const modules[] = {L"xinput1_4.dll", L"xinput1_3.dll", L"xinput9_1_0.dll"};
+        for(mimas_u32 i = 0; i < 3 && !gamepads->xinput_module; ++i) {
+            gamepads->xinput_module = LoadLibraryW(modules[i]);
+        }
+
+        if(!gamepads->xinput_module) {
+            // TODO: Error
+            return mimas_false;
+        }
+
+        gamepads->get_state = (void*)GetProcAddress(gamepads->xinput_module, "XInputGetState");
+        if(!gamepads->get_state) {
+            FreeLibrary(gamepads->xinput_module);
+            gamepads->xinput_module = NULL;
+            return mimas_false;
+        }
+
+        memset(gamepads->gamepads, 0, sizeof(gamepads->gamepads));
+        gamepads->event = ((Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform)->event;
+        _mimas_atomic_store_i32(&gamepads->running, mimas_true);
+        gamepads->thread = CreateThread(NULL, 0, gamepad_thread, gamepads, 0, NULL);
+        if(!gamepads->thread) {
+            _mimas_atomic_store_i32(&gamepads->running, mimas_false);
+            FreeLibrary(gamepads->xinput_module);
+            gamepads->xinput_module = NULL;
+            return mimas_false;
+        }
+        _mimas_atomic_store_i32(&gamepads->enabled, mimas_true);
+    } else if(!enabled && gamepads->thread) {
+        _mimas_atomic_store_i32(&gamepads->enabled, mimas_false);
+        _mimas_atomic_store_i32(&gamepads->running, mimas_false);
+        WaitForSingleObject(gamepads->thread, INFINITE);
+        CloseHandle(gamepads->thread);
+        FreeLibrary(gamepads->xinput_module);
+        gamepads->thread = NULL;
+        gamepads->xinput_module = NULL;
+        gamepads->get_state = NULL;
+    }
+
+    return mimas_true;
+}
+
+mimas_bool mimas_win_platform_get_gamepad_state(mimas_u32 const index, Mimas_Gamepad_State* const state) {
+    Mimas_Win_Gamepads* const gamepads = get_gamepads();
+    if(index >= MIMAS_MAX_GAMEPADS || !_mimas_atomic_load_i32(&gamepads->enabled)) {
+        memset(state, 0, sizeof(Mimas_Gamepad_State));
+        return mimas_false;
+    }
+
+    // Seqlock read. Retry until we copy the state without the input thread writing to it in the meantime.
+    Mimas_Win_Gamepad* const gamepad = &gamepads->gamepads[index];
+    mimas_u64 begin;
+    mimas_u64 end;
+    do {
+        begin = _mimas_atomic_load_u64(&gamepad->sequence);
+        _mimas_atomic_fence();
+        *state = gamepad->state;
+        _mimas_atomic_fence();
+        end = _mimas_atomic_load_u64(&gamepad->sequence);
+    } while((begin & 1) || begin != end);
+
+    return state->connected;
+}
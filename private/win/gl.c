@@ -5,7 +5,7 @@
 
 #include <wingdi.h>
 
-mimas_bool mimas_platform_init_gl_backend() {
+mimas_bool mimas_win_init_gl_backend() {
     Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
     Mimas_Win_Window* const dummy_window = (Mimas_Win_Window*)platform->dummy_window->native_window;
     if(!mimas_load_wgl(dummy_window->hdc)) {
@@ -15,27 +15,132 @@ mimas_bool mimas_platform_init_gl_backend() {
     return mimas_true;
 }
 
-void mimas_platform_terminate_gl_backend() {
+void mimas_win_terminate_gl_backend() {
     mimas_unload_wgl();
 }
 
-Mimas_GL_Context* mimas_platform_create_gl_context(mimas_i32 const major, mimas_i32 const minor, Mimas_GL_Profile const profile) {
+int mimas_win_choose_pixel_format(HDC const hdc, Mimas_Framebuffer_Config const* const config) {
+    if(!wglChoosePixelFormatARB) {
+        PIXELFORMATDESCRIPTOR const pfd = {
+            .nSize = sizeof(PIXELFORMATDESCRIPTOR),
+            .nVersion = 1,
+            .dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | (config->buffer_count > 1 ? PFD_DOUBLEBUFFER : 0),
+            .iPixelType = PFD_TYPE_RGBA,
+            .cColorBits = (BYTE)(config->red_bits + config->green_bits + config->blue_bits),
+            .cRedBits = (BYTE)config->red_bits,
+            .cGreenBits = (BYTE)config->green_bits,
+            .cBlueBits = (BYTE)config->blue_bits,
+            .cAlphaBits = (BYTE)config->alpha_bits,
+            .cDepthBits = (BYTE)config->depth_bits,
+            .cStencilBits = (BYTE)config->stencil_bits,
+        };
+        return ChoosePixelFormat(hdc, &pfd);
+    }
+
+    int attribs[40];
+    int count = 0;
+#define ADD_ATTRIB(name, value) (attribs[count] = (name), attribs[count + 1] = (value), count += 2)
+    ADD_ATTRIB(WGL_DRAW_TO_WINDOW_ARB, TRUE);
+    ADD_ATTRIB(WGL_SUPPORT_OPENGL_ARB, TRUE);
+    ADD_ATTRIB(WGL_ACCELERATION_ARB, WGL_FULL_ACCELERATION_ARB);
+    ADD_ATTRIB(WGL_PIXEL_TYPE_ARB, WGL_TYPE_RGBA_ARB);
+    ADD_ATTRIB(WGL_DOUBLE_BUFFER_ARB, config->buffer_count > 1);
+    ADD_ATTRIB(WGL_RED_BITS_ARB, config->red_bits);
+    ADD_ATTRIB(WGL_GREEN_BITS_ARB, config->green_bits);
+    ADD_ATTRIB(WGL_BLUE_BITS_ARB, config->blue_bits);
+    ADD_ATTRIB(WGL_ALPHA_BITS_ARB, config->alpha_bits);
+    ADD_ATTRIB(WGL_DEPTH_BITS_ARB, config->depth_bits);
+    ADD_ATTRIB(WGL_STENCIL_BITS_ARB, config->stencil_bits);
+    if(config->samples > 0) {
+        if(!mimas_wgl_has_extension(hdc, "WGL_ARB_multisample")) {
+            // TODO: Error
+            return 0;
+        }
+        ADD_ATTRIB(WGL_SAMPLE_BUFFERS_ARB, 1);
+        ADD_ATTRIB(WGL_SAMPLES_ARB, config->samples);
+    }
+    if(config->srgb) {
+        if(!mimas_wgl_has_extension(hdc, "WGL_ARB_framebuffer_sRGB") && !mimas_wgl_has_extension(hdc, "WGL_EXT_framebuffer_sRGB")) {
+            // TODO: Error
+            return 0;
+        }
+        ADD_ATTRIB(WGL_FRAMEBUFFER_SRGB_CAPABLE_ARB, TRUE);
+    }
+#undef ADD_ATTRIB
+    attribs[count] = 0;
+
+    // The formats are sorted by how well they match, so we take the first one.
+    int pixel_format = 0;
+    UINT format_count = 0;
+    if(!wglChoosePixelFormatARB(hdc, attribs, NULL, 1, &pixel_format, &format_count) || format_count == 0) {
+        return 0;
+    }
+    return pixel_format;
+}
+
+mimas_bool mimas_win_platform_create_gl_context(Mimas_GL_Context* const ctx, Mimas_GL_Context_Create_Info const* const info) {
     Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
-    Mimas_Win_Window* const native_window = (Mimas_Win_Window*)platform->dummy_window->native_window;
-    int const gl_profile = (profile == MIMAS_GL_COMPATIBILITY_PROFILE ? WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB : WGL_CONTEXT_CORE_PROFILE_BIT_ARB);
-    int const attrib_list[] = {WGL_CONTEXT_MAJOR_VERSION_ARB, major, WGL_CONTEXT_MINOR_VERSION_ARB, minor, WGL_CONTEXT_PROFILE_MASK_ARB, gl_profile, 0};
-    HGLRC const hglrc = wglCreateContextAttribsARB(native_window->hdc, NULL, attrib_list);
-    return (Mimas_GL_Context*)hglrc;
+    // The context inherits the pixel format of the window it is created for.
+    Mimas_Window* const window = info->window ? info->window : platform->dummy_window;
+    HDC const hdc = ((Mimas_Win_Window*)window->native_window)->hdc;
+    int const gl_profile = (info->profile == MIMAS_GL_COMPATIBILITY_PROFILE ? WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB : WGL_CONTEXT_CORE_PROFILE_BIT_ARB);
+    int context_flags = 0;
+    if(info->flags & MIMAS_GL_CONTEXT_DEBUG) {
+        context_flags |= WGL_CONTEXT_DEBUG_BIT_ARB;
+    }
+    if(info->flags & MIMAS_GL_CONTEXT_FORWARD_COMPATIBLE) {
+        context_flags |= WGL_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB;
+    }
+
+    int attribs[16];
+    int count = 0;
+#define ADD_ATTRIB(name, value) (attribs[count] = (name), attribs[count + 1] = (value), count += 2)
+    ADD_ATTRIB(WGL_CONTEXT_MAJOR_VERSION_ARB, info->version_major);
+    ADD_ATTRIB(WGL_CONTEXT_MINOR_VERSION_ARB, info->version_minor);
+    ADD_ATTRIB(WGL_CONTEXT_PROFILE_MASK_ARB, gl_profile);
+    if(info->flags & MIMAS_GL_CONTEXT_ROBUST) {
+        if(!mimas_wgl_has_extension(hdc, "WGL_ARB_create_context_robustness")) {
+            // TODO: Error
+            return mimas_false;
+        }
+        context_flags |= WGL_CONTEXT_ROBUST_ACCESS_BIT_ARB;
+        ADD_ATTRIB(WGL_CONTEXT_RESET_NOTIFICATION_STRATEGY_ARB, WGL_LOSE_CONTEXT_ON_RESET_ARB);
+    }
+    // no_error and the release behaviour are optimizations. The context behaves the same without them, so we drop them quietly.
+    if((info->flags & MIMAS_GL_CONTEXT_NO_ERROR) && mimas_wgl_has_extension(hdc, "WGL_ARB_create_context_no_error")) {
+        ADD_ATTRIB(WGL_CONTEXT_OPENGL_NO_ERROR_ARB, TRUE);
+    }
+    if(info->release_behavior == MIMAS_GL_RELEASE_BEHAVIOR_NONE && mimas_wgl_has_extension(hdc, "WGL_ARB_context_flush_control")) {
+        ADD_ATTRIB(WGL_CONTEXT_RELEASE_BEHAVIOR_ARB, WGL_CONTEXT_RELEASE_BEHAVIOR_NONE_ARB);
+    }
+    if(context_flags) {
+        ADD_ATTRIB(WGL_CONTEXT_FLAGS_ARB, context_flags);
+    }
+#undef ADD_ATTRIB
+    attribs[count] = 0;
+
+    HGLRC const hglrc = wglCreateContextAttribsARB(hdc, NULL, attribs);
+    if(!hglrc) {
+        // TODO: Error
+        return mimas_false;
+    }
+    ctx->native_context = hglrc;
+    return mimas_true;
 }
 
-void mimas_platform_destroy_gl_context(Mimas_GL_Context* const ctx) {
-    wglMakeCurrent(NULL, NULL);
-    wglDeleteContext((HGLRC)ctx);
+void mimas_win_platform_destroy_gl_context(Mimas_GL_Context* const ctx) {
+    HGLRC const hglrc = (HGLRC)ctx->native_context;
+    // Leave other contexts current on this thread alone.
+    if(wglGetCurrentContext() == hglrc) {
+        wglMakeCurrent(NULL, NULL);
+    }
+    wglDeleteContext(hglrc);
 }
 
-mimas_bool mimas_platform_make_context_current(Mimas_Window* const window, Mimas_GL_Context* const ctx) {
+mimas_bool mimas_win_platform_make_context_current(Mimas_Window* const window, Mimas_GL_Context* const ctx) {
     Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
-    if(!wglMakeCurrent(native_window->hdc, (HGLRC)ctx)) {
+    HGLRC const hglrc = ctx ? (HGLRC)ctx->native_context : NULL;
+    if(!wglMakeCurrent(native_window->hdc, hglrc)) {
         // TODO: Error
         return mimas_false;
     }
@@ -43,15 +148,19 @@ mimas_bool mimas_platform_make_context_current(Mimas_Window* const window, Mimas
     return mimas_true;
 }
 
-void mimas_platform_swap_buffers(Mimas_Window* const window) {
+void mimas_win_platform_swap_buffers(Mimas_Window* const window) {
     Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
     wglSwapBuffers(native_window->hdc);
 }
 
-void mimas_platform_set_swap_interval(mimas_i32 const interval) {
+void mimas_win_platform_set_swap_interval(mimas_i32 const interval) {
     wglSwapIntervalEXT(interval);
 }
 
-mimas_i32 mimas_platform_get_swap_interval() {
+mimas_i32 mimas_win_platform_get_swap_interval() {
     return wglGetSwapIntervalEXT();
 }
+
+Mimas_GL_Proc mimas_win_platform_get_gl_proc_address(char const* const name) {
+    return (Mimas_GL_Proc)mimas_wgl_get_proc_address(name);
+}
@@ -2,14 +2,21 @@
 #include <win/platform.h>
 #include <mimas/mimas.h>
 
-void mimas_platform_get_cursor_pos(mimas_i32* const x, mimas_i32* const y) {
+void mimas_win_platform_get_cursor_pos(mimas_i32* const x, mimas_i32* const y) {
+    Mimas_Win_Platform const* const platform = (Mimas_Win_Platform const*)_mimas_get_mimas_internal()->platform;
+    if(platform->cursor_window) {
+        *x = platform->cursor_x;
+        *y = platform->cursor_y;
+        return;
+    }
+
     POINT cursor = {0, 0};
     GetCursorPos(&cursor);
     *x = cursor.x;
     *y = cursor.y;
 }
 
-Mimas_Mouse_Button_Action mimas_platform_get_mouse_button(Mimas_Mouse_Button button) {
+Mimas_Mouse_Button_Action mimas_win_platform_get_mouse_button(Mimas_Mouse_Button button) {
     Mimas_Win_Platform const* platform = (Mimas_Win_Platform const*)_mimas_get_mimas_internal()->platform;
     return platform->mouse_state[button];
 }  
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include <win/platform.h>
+#include <internal.h>
+
+#include <string.h>
+
+static Mimas_Win_Monitors* get_monitors() {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    return &platform->monitors;
+}
+
+static BOOL CALLBACK collect_monitor(HMONITOR const handle, HDC const hdc, LPRECT const rect, LPARAM const user_data) {
+    Mimas_Win_Monitors* const monitors = (Mimas_Win_Monitors*)user_data;
+    if(monitors->count == monitors->capacity) {
+        mimas_u32 const capacity = monitors->capacity ? monitors->capacity * 2 : 4;
+        // On failure we stop enumerating and keep the monitors collected so far.
+        HMONITOR* const handles = (HMONITOR*)_mimas_realloc(monitors->handles, capacity * sizeof(HMONITOR));
+        if(!handles) {
+            return FALSE;
+        }
+        monitors->handles = handles;
+
+        Mimas_Monitor* const monitor_infos = (Mimas_Monitor*)_mimas_realloc(monitors->monitors, capacity * sizeof(Mimas_Monitor));
+        if(!monitor_infos) {
+            return FALSE;
+        }
+        monitors->monitors = monitor_infos;
+        monitors->capacity = capacity;
+    }
+
+    monitors->handles[monitors->count] = handle;
+    monitors->count += 1;
+    return TRUE;
+}
+
+static Mimas_Rect rect_from_win_rect(RECT const rect) {
+    return (Mimas_Rect){.left = rect.left, .top = rect.top, .right = rect.right, .bottom = rect.bottom};
+}
+
+// Fills in the exact refresh rates from the display configuration.
+// Returns mimas_false if the display configuration API is unavailable.
+static mimas_bool query_refresh_rates(Mimas_Win_Monitors* const monitors) {
+    UINT32 path_count = 0;
+    UINT32 mode_count = 0;
+    if(GetDisplayConfigBufferSizes(QDC_ONLY_ACTIVE_PATHS, &path_count, &mode_count) != ERROR_SUCCESS) {
+        return mimas_false;
+    }
+
+    DISPLAYCONFIG_PATH_INFO* const paths = (DISPLAYCONFIG_PATH_INFO*)_mimas_malloc(path_count * sizeof(DISPLAYCONFIG_PATH_INFO));
+    DISPLAYCONFIG_MODE_INFO* const modes = (DISPLAYCONFIG_MODE_INFO*)_mimas_malloc(mode_count * sizeof(DISPLAYCONFIG_MODE_INFO));
+    mimas_bool const res = QueryDisplayConfig(QDC_ONLY_ACTIVE_PATHS, &path_count, paths, &mode_count, modes, NULL) == ERROR_SUCCESS;
+    if(res) {
+        for(UINT32 i = 0; i < path_count; ++i) {
+            DISPLAYCONFIG_SOURCE_DEVICE_NAME source = {
+                .header = {
+                    .type = DISPLAYCONFIG_DEVICE_INFO_GET_SOURCE_NAME,
+                    .size = sizeof(DISPLAYCONFIG_SOURCE_DEVICE_NAME),
+                    .adapterId = paths[i].sourceInfo.adapterId,
+                    .id = paths[i].sourceInfo.id,
+                },
+            };
+            if(DisplayConfigGetDeviceInfo(&source.header) != ERROR_SUCCESS) {
+                continue;
+            }
+
+            DISPLAYCONFIG_RATIONAL const refresh_rate = paths[i].targetInfo.refreshRate;
+            for(mimas_u32 j = 0; j < monitors->count; ++j) {
+                MONITORINFOEXW info = {.cbSize = sizeof(MONITORINFOEXW)};
+                if(GetMonitorInfoW(monitors->handles[j], (MONITORINFO*)&info) && wcscmp(info.szDevice, source.viewGdiDeviceName) == 0 && refresh_rate.Denominator != 0) {
+                    monitors->monitors[j].refresh_rate_numerator = refresh_rate.Numerator;
+                    monitors->monitors[j].refresh_rate_denominator = refresh_rate.Denominator;
+                }
+            }
+        }
+    }
+
+    _mimas_free(modes);
+    _mimas_free(paths);
+    return res;
+}
+
+static void refresh_monitors(Mimas_Win_Monitors* const monitors) {
+    monitors->count = 0;
+    EnumDisplayMonitors(NULL, NULL, collect_monitor, (LPARAM)monitors);
+
+    for(mimas_u32 i = 0; i < monitors->count; ++i) {
+        Mimas_Monitor* const monitor = &monitors->monitors[i];
+        memset(monitor, 0, sizeof(Mimas_Monitor));
+
+        MONITORINFOEXW info = {.cbSize = sizeof(MONITORINFOEXW)};
+        if(!GetMonitorInfoW(monitors->handles[i], (MONITORINFO*)&info)) {
+            continue;
+        }
+
+        WideCharToMultiByte(CP_UTF8, 0, info.szDevice, -1, monitor->name, sizeof(monitor->name), NULL, NULL);
+        monitor->rect = rect_from_win_rect(info.rcMonitor);
+        monitor->work_rect = rect_from_win_rect(info.rcWork);
+        monitor->content_scale = (float)mimas_win_get_monitor_dpi(monitors->handles[i]) / USER_DEFAULT_SCREEN_DPI;
+        monitor->primary = (info.dwFlags & MONITORINFOF_PRIMARY) != 0;
+
+        // Integer fallback for systems without the display configuration API.
+        DEVMODEW mode = {.dmSize = sizeof(DEVMODEW)};
+        // Frequencies of 0 and 1 denote the hardware default and carry no information.
+        if(EnumDisplaySettingsW(info.szDevice, ENUM_CURRENT_SETTINGS, &mode) && mode.dmDisplayFrequency > 1) {
+            monitor->refresh_rate_numerator = mode.dmDisplayFrequency;
+            monitor->refresh_rate_denominator = 1;
+        }
+    }
+
+    query_refresh_rates(monitors);
+
+    // Move the primary monitor to the front.
+    for(mimas_u32 i = 1; i < monitors->count; ++i) {
+        if(monitors->monitors[i].primary) {
+            Mimas_Monitor const monitor = monitors->monitors[i];
+            HMONITOR const handle = monitors->handles[i];
+            monitors->monitors[i] = monitors->monitors[0];
+            monitors->handles[i] = monitors->handles[0];
+            monitors->monitors[0] = monitor;
+            monitors->handles[0] = handle;
+            break;
+        }
+    }
+
+    monitors->dirty = mimas_false;
+    monitors->refreshed = mimas_true;
+}
+
+mimas_u32 mimas_win_platform_get_monitors(Mimas_Monitor* const monitors, mimas_u32 const capacity) {
+    Mimas_Win_Monitors* const cache = get_monitors();
+    if(cache->dirty) {
+        refresh_monitors(cache);
+    }
+
+    mimas_u32 const count = cache->count < capacity ? cache->count : capacity;
+    if(monitors && count > 0) {
+        memcpy(monitors, cache->monitors, count * sizeof(Mimas_Monitor));
+    }
+    return cache->count;
+}
+
+mimas_bool mimas_win_platform_update_monitors() {
+    Mimas_Win_Monitors* const cache = get_monitors();
+    if(cache->dirty) {
+        refresh_monitors(cache);
+    }
+
+    if(!cache->refreshed) {
+        return mimas_false;
+    }
+    cache->refreshed = mimas_false;
+
+    // Notifications are also sent for changes that do not affect any monitor, e.g. a window moving to another monitor.
+    mimas_bool const changed = cache->reported_count != cache->count || (cache->count > 0 && memcmp(cache->reported, cache->monitors, cache->count * sizeof(Mimas_Monitor)) != 0);
+    if(!changed) {
+        return mimas_false;
+    }
+
+    if(cache->count > cache->reported_capacity) {
+        Mimas_Monitor* const reported = (Mimas_Monitor*)_mimas_realloc(cache->reported, cache->count * sizeof(Mimas_Monitor));
+        if(!reported) {
+            // The stale snapshot makes the next refresh report a change again, which is better than missing one.
+            return mimas_true;
+        }
+        cache->reported = reported;
+        cache->reported_capacity = cache->count;
+    }
+
+    if(cache->count > 0) {
+        memcpy(cache->reported, cache->monitors, cache->count * sizeof(Mimas_Monitor));
+    }
+    cache->reported_count = cache->count;
+    return mimas_true;
+}
+
+mimas_bool mimas_win_platform_get_frame_timing(Mimas_Window* const window, mimas_u64* const vblank_ns, mimas_u64* const period_ns) {
+    // DWM presents all windows on one clock. The window must be NULL since Windows 8.1.
+    DWM_TIMING_INFO timing = {.cbSize = sizeof(DWM_TIMING_INFO)};
+    if(SUCCEEDED(DwmGetCompositionTimingInfo(NULL, &timing)) && timing.qpcRefreshPeriod > 0) {
+        *vblank_ns = mimas_win_qpc_to_ns(timing.qpcVBlank);
+        *period_ns = mimas_win_qpc_to_ns(timing.qpcRefreshPeriod);
+        return mimas_true;
+    }
+
+    // Without composition we only know the refresh rate of the monitor the window is on.
+    HWND const hwnd = ((Mimas_Win_Window*)window->native_window)->handle;
+    MONITORINFOEXW info = {.cbSize = sizeof(MONITORINFOEXW)};
+    DEVMODEW mode = {.dmSize = sizeof(DEVMODEW)};
+    if(!GetMonitorInfoW(MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST), (MONITORINFO*)&info) ||
+       !EnumDisplaySettingsW(info.szDevice, ENUM_CURRENT_SETTINGS, &mode) || mode.dmDisplayFrequency <= 1) {
+        return mimas_false;
+    }
+
+    *vblank_ns = 0;
+    *period_ns = 1000000000ULL / mode.dmDisplayFrequency;
+    return mimas_true;
+}
+
+HMONITOR mimas_win_get_monitor_handle(mimas_u32 const index) {
+    Mimas_Win_Monitors* const cache = get_monitors();
+    if(cache->dirty) {
+        refresh_monitors(cache);
+    }
+    return index < cache->count ? cache->handles[index] : NULL;
+}
+
+void mimas_win_invalidate_monitors() {
+    get_monitors()->dirty = mimas_true;
+}
+
+void mimas_win_terminate_monitors(Mimas_Win_Platform* const platform) {
+    Mimas_Win_Monitors* const monitors = &platform->monitors;
+    _mimas_free(monitors->monitors);
+    _mimas_free(monitors->handles);
+    _mimas_free(monitors->reported);
+    memset(monitors, 0, sizeof(Mimas_Win_Monitors));
+}
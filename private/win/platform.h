@@ -12,20 +12,180 @@
 #include <dwmapi.h>
 
 #include <mimas/mimas.h>
+#include <platform.h>
 
 #define MIMAS_WINDOW_CLASS_NAME L"anton.mimas.mingwlul.window"
+#define MIMAS_HELPER_WINDOW_CLASS_NAME L"anton.mimas.mingwlul.helper"
+
+typedef enum {
+    MIMAS_WIN_MOUSE_TRACKING_NONE,
+    MIMAS_WIN_MOUSE_TRACKING_CLIENT,
+    MIMAS_WIN_MOUSE_TRACKING_NONCLIENT,
+} Mimas_Win_Mouse_Tracking;
 
 typedef struct {
     HWND handle;
     HDC hdc;
+    // Pending high surrogate of a UTF-16 surrogate pair received through WM_CHAR.
+    WCHAR high_surrogate;
+    // Whether the window is in the modal move/resize loop.
+    mimas_bool in_size_move;
+    // Geometry in screen coordinates, refreshed on WM_WINDOWPOSCHANGED so that queries do not call into the system.
+    RECT window_rect;
+    RECT client_rect;
+    // The part of the window for which we have requested WM_MOUSELEAVE or WM_NCMOUSELEAVE.
+    Mimas_Win_Mouse_Tracking mouse_tracking;
+    // Style and placement to go back to when the window leaves fullscreen.
+    DWORD windowed_style;
+    WINDOWPLACEMENT windowed_placement;
+    HMONITOR fullscreen_monitor;
+    // Video mode of exclusive fullscreen. dmFields is 0 if the window keeps the current mode.
+    // The mode is only set on display_device while the window is active.
+    WCHAR display_device[CCHDEVICENAME];
+    DEVMODEW display_mode;
+    mimas_bool display_mode_set;
+    // Injection time of the oldest key posted by mimas_inject_key that has not been delivered yet. 0 if there is none.
+    mimas_u64 volatile injected_key_ns;
 } Mimas_Win_Window;
 
+// Marks keyboard messages posted by mimas_inject_key in one of the reserved bits of lparam.
+#define MIMAS_WIN_INJECTED_KEY 0x10000000
+
+// Timer that reports pending resizes during the modal resize loop.
+#define MIMAS_RESIZE_TIMER_ID 1
+
+typedef struct {
+    Mimas_Clipboard_Offer offer;
+    // Copies of offer.mime_types and their native clipboard formats.
+    char** mime_types;
+    UINT* formats;
+} Mimas_Win_Clipboard;
+
+typedef struct {
+    // Odd while the input thread is writing the state.
+    mimas_u64 volatile sequence;
+    Mimas_Gamepad_State state;
+} Mimas_Win_Gamepad;
+
+typedef struct {
+    HMODULE xinput_module;
+    void* get_state;
+    // Owned by the thread that enables and disables the input.
+    HANDLE thread;
+    // Tells the input thread to keep polling.
+    mimas_i32 volatile running;
+    // Set once the input thread runs and cleared before it is stopped. Read by mimas_get_gamepad_state on any thread.
+    mimas_i32 volatile enabled;
+    // Signaled when the state of a gamepad changes.
+    HANDLE event;
+    Mimas_Win_Gamepad gamepads[MIMAS_MAX_GAMEPADS];
+} Mimas_Win_Gamepads;
+
+typedef UINT (WINAPI* PFN_GetDpiForWindow)(HWND);
+typedef BOOL (WINAPI* PFN_AdjustWindowRectExForDpi)(RECT*, DWORD, BOOL, DWORD, UINT);
+typedef BOOL (WINAPI* PFN_SetProcessDpiAwarenessContext)(HANDLE);
+typedef HRESULT (WINAPI* PFN_SetProcessDpiAwareness)(int);
+typedef HRESULT (WINAPI* PFN_GetDpiForMonitor)(HMONITOR, int, UINT*, UINT*);
+
+// DPI functions that are not available on all versions of Windows. Any of them may be NULL.
+typedef struct {
+    HMODULE shcore_module;
+    PFN_GetDpiForWindow GetDpiForWindow;
+    PFN_AdjustWindowRectExForDpi AdjustWindowRectExForDpi;
+    PFN_GetDpiForMonitor GetDpiForMonitor;
+} Mimas_Win_DPI;
+
+typedef struct {
+    Mimas_Monitor* monitors;
+    HMONITOR* handles;
+    mimas_u32 count;
+    mimas_u32 capacity;
+    // Set when the system notifies us of a display change. The monitors are queried again on the next access.
+    mimas_bool dirty;
+    // Set by every query of the monitors and cleared by mimas_win_platform_update_monitors.
+    mimas_bool refreshed;
+    // Monitors as of the last call to mimas_win_platform_update_monitors, which reports changes against them.
+    // Kept separately because any access may query the monitors before the change has been reported.
+    Mimas_Monitor* reported;
+    mimas_u32 reported_count;
+    mimas_u32 reported_capacity;
+} Mimas_Win_Monitors;
+
+// Hidden windows created in advance for mimas_create_window.
+typedef struct {
+    Mimas_Window** windows;
+    mimas_u32 count;
+    // Number of windows the pool is refilled to.
+    mimas_u32 size;
+} Mimas_Win_Window_Pool;
+
 typedef struct {
     mimas_u8 keyboard_state[256];
     mimas_u8 mouse_state[3];
     mimas_i32 virtaul_keys[256];
     Mimas_Key keys[256];
+    // Hidden window with the default pixel format. GL contexts are created for it unless the user passes a window.
     Mimas_Window* dummy_window;
+    // Hidden window that owns the clipboard and receives broadcast messages.
+    HWND helper_window;
+    Mimas_Win_Clipboard clipboard;
+    Mimas_Win_Gamepads gamepads;
+    Mimas_Win_DPI dpi;
+    Mimas_Win_Monitors monitors;
+    // Window the cursor is over. NULL if the cursor is outside of our windows and cursor_x and cursor_y are stale.
+    HWND cursor_window;
+    Mimas_Win_Window_Pool window_pool;
+    // Signaled for work that does not arrive through the message queue. Reset by mimas_win_platform_poll_events.
+    HANDLE event;
+    // High resolution timer that ends finite waits of mimas_win_platform_wait_events. Created on the first such wait.
+    HANDLE wait_timer;
+    mimas_bool wait_timer_created;
+    // Pixel format chosen for pixel_format_config. Choosing a format is slow and most windows share one config,
+    // so we remember the last one. 0 if nothing is cached.
+    int pixel_format;
+    // Whether pixel_format was chosen by wglChoosePixelFormatARB rather than ChoosePixelFormat.
+    mimas_bool pixel_format_arb;
+    Mimas_Framebuffer_Config pixel_format_config;
+    // Cursor position in screen coordinates as of the last mouse move message.
+    mimas_i32 cursor_x;
+    mimas_i32 cursor_y;
 } Mimas_Win_Platform;
 
+#define _MIMAS_WIN_DECLARE_PLATFORM_FUNCTION(return_type, function, parameters) return_type mimas_win_platform_##function parameters;
+MIMAS_PLATFORM_FUNCTIONS(_MIMAS_WIN_DECLARE_PLATFORM_FUNCTION)
+#undef _MIMAS_WIN_DECLARE_PLATFORM_FUNCTION
+
+mimas_bool mimas_win_init_gl_backend();
+void mimas_win_terminate_gl_backend();
+// Returns the pixel format that best matches config or 0 if there is none.
+// Uses wglChoosePixelFormatARB once the GL backend is initialized and ChoosePixelFormat before that.
+int mimas_win_choose_pixel_format(HDC, Mimas_Framebuffer_Config const* config);
+mimas_bool mimas_win_init_vk_backend();
+void mimas_win_terminate_vk_backend();
+
+// Converts a QueryPerformanceCounter value to the clock of mimas_platform_get_time_ns.
+mimas_u64 mimas_win_qpc_to_ns(mimas_u64 ticks);
+// Sleep and wait timeouts are rounded to the system timer resolution, which is 15.6 ms unless a process raises it.
+// Returns a waitable timer that is not subject to it, or NULL before Windows 10 1803.
+HANDLE mimas_win_create_high_resolution_timer();
+// Arms timer to be signaled once after timeout_ns.
+mimas_bool mimas_win_set_timer(HANDLE timer, mimas_u64 timeout_ns);
+
+void mimas_win_invalidate_monitors();
+// Returns the handle of the monitor at index in the order of mimas_get_monitors or NULL if there is no such monitor.
+HMONITOR mimas_win_get_monitor_handle(mimas_u32 index);
+void mimas_win_terminate_monitors(Mimas_Win_Platform*);
+
+// Makes the process per-monitor DPI aware and loads the DPI functions.
+void mimas_win_init_dpi(Mimas_Win_Platform*);
+void mimas_win_terminate_dpi(Mimas_Win_Platform*);
+UINT mimas_win_get_window_dpi(HWND);
+UINT mimas_win_get_monitor_dpi(HMONITOR);
+void mimas_win_adjust_window_rect(RECT*, DWORD style, DWORD ex_style, UINT dpi);
+
+// Handlers for the clipboard messages received by the helper window.
+void mimas_win_render_clipboard_format(UINT format);
+void mimas_win_render_all_clipboard_formats();
+void mimas_win_release_clipboard();
+
 #endif // !MIMAS_WIN_PLATFORM_H_INCLUDE
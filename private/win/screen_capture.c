@@ -0,0 +1,304 @@
+#define COBJMACROS
+#include <win/platform.h>
+#include <platform.h>
+#include <internal.h>
+
+#include <d3d11.h>
+#include <dxgi1_2.h>
+
+#include <string.h>
+
+// Screen capture through the DXGI desktop duplication API.
+// The system reports the dirty and moved regions of every desktop frame, so we only copy those
+// from the desktop texture to a staging texture and from there into the persistent buffer.
+
+struct Mimas_Screen_Capture {
+    HMONITOR monitor;
+    IDXGIOutput1* output;
+    ID3D11Device* device;
+    ID3D11DeviceContext* context;
+    // NULL after the duplication has been lost and could not be recreated yet.
+    IDXGIOutputDuplication* duplication;
+    ID3D11Texture2D* staging;
+    mimas_i32 width;
+    mimas_i32 height;
+    // BGRA8 copy of the monitor.
+    mimas_u8* pixels;
+    // Set when the buffer does not match the desktop anymore and the next frame has to be copied in full.
+    mimas_bool full_copy;
+
+    // Move and dirty rects of the current frame as reported by the system.
+    mimas_u8* metadata;
+    UINT metadata_size;
+    Mimas_Rect* dirty_rects;
+    mimas_u32 dirty_rect_count;
+    mimas_u32 dirty_rect_capacity;
+};
+
+static void release_duplication(Mimas_Screen_Capture* const capture) {
+    if(capture->staging) {
+        ID3D11Texture2D_Release(capture->staging);
+        capture->staging = NULL;
+    }
+    if(capture->duplication) {
+        IDXGIOutputDuplication_Release(capture->duplication);
+        capture->duplication = NULL;
+    }
+}
+
+// (Re)creates the duplication and, if the size of the desktop has changed, the staging texture and the buffer.
+static mimas_bool create_duplication(Mimas_Screen_Capture* const capture) {
+    release_duplication(capture);
+    if(FAILED(IDXGIOutput1_DuplicateOutput(capture->output, (IUnknown*)capture->device, &capture->duplication))) {
+        capture->duplication = NULL;
+        return mimas_false;
+    }
+
+    DXGI_OUTDUPL_DESC desc;
+    IDXGIOutputDuplication_GetDesc(capture->duplication, &desc);
+    D3D11_TEXTURE2D_DESC const staging_desc = {
+        .Width = desc.ModeDesc.Width,
+        .Height = desc.ModeDesc.Height,
+        .MipLevels = 1,
+        .ArraySize = 1,
+        .Format = DXGI_FORMAT_B8G8R8A8_UNORM,
+        .SampleDesc = {.Count = 1, .Quality = 0},
+        .Usage = D3D11_USAGE_STAGING,
+        .BindFlags = 0,
+        .CPUAccessFlags = D3D11_CPU_ACCESS_READ,
+        .MiscFlags = 0,
+    };
+    if(FAILED(ID3D11Device_CreateTexture2D(capture->device, &staging_desc, NULL, &capture->staging))) {
+        capture->staging = NULL;
+        release_duplication(capture);
+        return mimas_false;
+    }
+
+    mimas_i32 const width = (mimas_i32)desc.ModeDesc.Width;
+    mimas_i32 const height = (mimas_i32)desc.ModeDesc.Height;
+    if(width != capture->width || height != capture->height) {
+        _mimas_free(capture->pixels);
+        capture->pixels = (mimas_u8*)_mimas_malloc((mimas_u64)width * (mimas_u64)height * 4);
+        capture->width = width;
+        capture->height = height;
+    }
+    // Frames that have been presented while we had no duplication are not reported as dirty.
+    capture->full_copy = mimas_true;
+    return mimas_true;
+}
+
+static IDXGIOutput1* find_output(IDXGIFactory1* const factory, HMONITOR const monitor, IDXGIAdapter1** const adapter_out) {
+    IDXGIAdapter1* adapter = NULL;
+    for(UINT a = 0; IDXGIFactory1_EnumAdapters1(factory, a, &adapter) != DXGI_ERROR_NOT_FOUND; ++a) {
+        IDXGIOutput* output = NULL;
+        for(UINT o = 0; IDXGIAdapter1_EnumOutputs(adapter, o, &output) != DXGI_ERROR_NOT_FOUND; ++o) {
+            DXGI_OUTPUT_DESC desc;
+            IDXGIOutput_GetDesc(output, &desc);
+            if(desc.Monitor == monitor) {
+                IDXGIOutput1* output1 = NULL;
+                HRESULT const res = IDXGIOutput_QueryInterface(output, &IID_IDXGIOutput1, (void**)&output1);
+                IDXGIOutput_Release(output);
+                if(FAILED(res)) {
+                    IDXGIAdapter1_Release(adapter);
+                    return NULL;
+                }
+                *adapter_out = adapter;
+                return output1;
+            }
+            IDXGIOutput_Release(output);
+        }
+        IDXGIAdapter1_Release(adapter);
+    }
+    return NULL;
+}
+
+Mimas_Screen_Capture* mimas_win_platform_create_screen_capture(mimas_u32 const monitor_index) {
+    HMONITOR const monitor = mimas_win_get_monitor_handle(monitor_index);
+    if(!monitor) {
+        // TODO: Error
+        return NULL;
+    }
+
+    IDXGIFactory1* factory = NULL;
+    if(FAILED(CreateDXGIFactory1(&IID_IDXGIFactory1, (void**)&factory))) {
+        // TODO: Error
+        return NULL;
+    }
+
+    IDXGIAdapter1* adapter = NULL;
+    IDXGIOutput1* const output = find_output(factory, monitor, &adapter);
+    IDXGIFactory1_Release(factory);
+    if(!output) {
+        // TODO: Error
+        return NULL;
+    }
+
+    // The duplication must be created on a device of the adapter the monitor is connected to.
+    ID3D11Device* device = NULL;
+    ID3D11DeviceContext* context = NULL;
+    HRESULT const res = D3D11CreateDevice((IDXGIAdapter*)adapter, D3D_DRIVER_TYPE_UNKNOWN, NULL, 0, NULL, 0, D3D11_SDK_VERSION, &device, NULL, &context);
+    IDXGIAdapter1_Release(adapter);
+    if(FAILED(res)) {
+        IDXGIOutput1_Release(output);
+        // TODO: Error
+        return NULL;
+    }
+
+    Mimas_Screen_Capture* const capture = (Mimas_Screen_Capture*)_mimas_malloc(sizeof(Mimas_Screen_Capture));
+    memset(capture, 0, sizeof(Mimas_Screen_Capture));
+    capture->monitor = monitor;
+    capture->output = output;
+    capture->device = device;
+    capture->context = context;
+    if(!create_duplication(capture)) {
+        mimas_win_platform_destroy_screen_capture(capture);
+        // TODO: Error
+        return NULL;
+    }
+    return capture;
+}
+
+void mimas_win_platform_destroy_screen_capture(Mimas_Screen_Capture* const capture) {
+    release_duplication(capture);
+    ID3D11DeviceContext_Release(capture->context);
+    ID3D11Device_Release(capture->device);
+    IDXGIOutput1_Release(capture->output);
+    _mimas_free(capture->pixels);
+    _mimas_free(capture->metadata);
+    _mimas_free(capture->dirty_rects);
+    _mimas_free(capture);
+}
+
+static void add_dirty_rect(Mimas_Screen_Capture* const capture, RECT const rect) {
+    // Clamp to the desktop in case the metadata is from before a mode change.
+    LONG const left = rect.left > 0 ? rect.left : 0;
+    LONG const top = rect.top > 0 ? rect.top : 0;
+    LONG const right = rect.right < capture->width ? rect.right : capture->width;
+    LONG const bottom = rect.bottom < capture->height ? rect.bottom : capture->height;
+    if(left >= right || top >= bottom) {
+        return;
+    }
+
+    if(capture->dirty_rect_count == capture->dirty_rect_capacity) {
+        mimas_u32 const capacity = capture->dirty_rect_capacity ? capture->dirty_rect_capacity * 2 : 16;
+        capture->dirty_rects = (Mimas_Rect*)_mimas_realloc(capture->dirty_rects, capacity * sizeof(Mimas_Rect));
+        capture->dirty_rect_capacity = capacity;
+    }
+    capture->dirty_rects[capture->dirty_rect_count] = (Mimas_Rect){.left = left, .top = top, .right = right, .bottom = bottom};
+    capture->dirty_rect_count += 1;
+}
+
+// Collects the regions that have changed in the current frame.
+// Moved regions are treated as dirty at their destination because the desktop texture already contains the result of the move.
+static mimas_bool collect_dirty_rects(Mimas_Screen_Capture* const capture, DXGI_OUTDUPL_FRAME_INFO const* const info) {
+    capture->dirty_rect_count = 0;
+    if(capture->full_copy) {
+        add_dirty_rect(capture, (RECT){0, 0, capture->width, capture->height});
+        return mimas_true;
+    }
+
+    if(info->TotalMetadataBufferSize == 0) {
+        return mimas_true;
+    }
+
+    if(capture->metadata_size < info->TotalMetadataBufferSize) {
+        _mimas_free(capture->metadata);
+        capture->metadata = (mimas_u8*)_mimas_malloc(info->TotalMetadataBufferSize);
+        capture->metadata_size = info->TotalMetadataBufferSize;
+    }
+
+    UINT move_size = 0;
+    DXGI_OUTDUPL_MOVE_RECT* const moves = (DXGI_OUTDUPL_MOVE_RECT*)capture->metadata;
+    if(FAILED(IDXGIOutputDuplication_GetFrameMoveRects(capture->duplication, capture->metadata_size, moves, &move_size))) {
+        return mimas_false;
+    }
+    for(UINT i = 0; i < move_size / sizeof(DXGI_OUTDUPL_MOVE_RECT); ++i) {
+        add_dirty_rect(capture, moves[i].DestinationRect);
+    }
+
+    UINT dirty_size = 0;
+    RECT* const dirty = (RECT*)(capture->metadata + move_size);
+    if(FAILED(IDXGIOutputDuplication_GetFrameDirtyRects(capture->duplication, capture->metadata_size - move_size, dirty, &dirty_size))) {
+        return mimas_false;
+    }
+    for(UINT i = 0; i < dirty_size / sizeof(RECT); ++i) {
+        add_dirty_rect(capture, dirty[i]);
+    }
+    return mimas_true;
+}
+
+// Copies the dirty rects of the desktop texture into the buffer.
+static mimas_bool copy_dirty_rects(Mimas_Screen_Capture* const capture, ID3D11Texture2D* const desktop) {
+    for(mimas_u32 i = 0; i < capture->dirty_rect_count; ++i) {
+        Mimas_Rect const r = capture->dirty_rects[i];
+        D3D11_BOX const box = {.left = (UINT)r.left, .top = (UINT)r.top, .front = 0, .right = (UINT)r.right, .bottom = (UINT)r.bottom, .back = 1};
+        ID3D11DeviceContext_CopySubresourceRegion(capture->context, (ID3D11Resource*)capture->staging, 0, (UINT)r.left, (UINT)r.top, 0, (ID3D11Resource*)desktop, 0, &box);
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if(FAILED(ID3D11DeviceContext_Map(capture->context, (ID3D11Resource*)capture->staging, 0, D3D11_MAP_READ, 0, &mapped))) {
+        return mimas_false;
+    }
+
+    mimas_u64 const stride = (mimas_u64)capture->width * 4;
+    for(mimas_u32 i = 0; i < capture->dirty_rect_count; ++i) {
+        Mimas_Rect const r = capture->dirty_rects[i];
+        mimas_u64 const row_size = (mimas_u64)(r.right - r.left) * 4;
+        for(mimas_i32 y = r.top; y < r.bottom; ++y) {
+            mimas_u8 const* const src = (mimas_u8 const*)mapped.pData + (mimas_u64)mapped.RowPitch * y + (mimas_u64)r.left * 4;
+            memcpy(capture->pixels + stride * y + (mimas_u64)r.left * 4, src, row_size);
+        }
+    }
+    ID3D11DeviceContext_Unmap(capture->context, (ID3D11Resource*)capture->staging, 0);
+    return mimas_true;
+}
+
+mimas_bool mimas_win_platform_capture_screen(Mimas_Screen_Capture* const capture, mimas_u32 const timeout_ms, Mimas_Screen_Frame* const frame) {
+    if(!capture->duplication && !create_duplication(capture)) {
+        // The desktop is still unavailable, e.g. while the secure desktop is shown.
+        return mimas_false;
+    }
+
+    DXGI_OUTDUPL_FRAME_INFO info;
+    IDXGIResource* resource = NULL;
+    UINT const timeout = timeout_ms == MIMAS_WAIT_FOREVER ? INFINITE : timeout_ms;
+    HRESULT const res = IDXGIOutputDuplication_AcquireNextFrame(capture->duplication, timeout, &info, &resource);
+    if(res == DXGI_ERROR_WAIT_TIMEOUT) {
+        return mimas_false;
+    }
+    if(res == DXGI_ERROR_ACCESS_LOST) {
+        create_duplication(capture);
+        return mimas_false;
+    }
+    if(FAILED(res)) {
+        // TODO: Error
+        return mimas_false;
+    }
+
+    // Frames that only update the mouse pointer do not change the desktop image.
+    mimas_bool updated = mimas_false;
+    if(info.LastPresentTime.QuadPart != 0 || capture->full_copy) {
+        ID3D11Texture2D* desktop = NULL;
+        if(SUCCEEDED(IDXGIResource_QueryInterface(resource, &IID_ID3D11Texture2D, (void**)&desktop))) {
+            if(collect_dirty_rects(capture, &info) && capture->dirty_rect_count > 0) {
+                updated = copy_dirty_rects(capture, desktop);
+            }
+            ID3D11Texture2D_Release(desktop);
+        }
+    }
+    IDXGIResource_Release(resource);
+    IDXGIOutputDuplication_ReleaseFrame(capture->duplication);
+    if(!updated) {
+        return mimas_false;
+    }
+
+    capture->full_copy = mimas_false;
+    frame->pixels = capture->pixels;
+    frame->width = capture->width;
+    frame->height = capture->height;
+    frame->stride = capture->width * 4;
+    frame->dirty_rects = capture->dirty_rects;
+    frame->dirty_rect_count = capture->dirty_rect_count;
+    frame->timestamp_ns = mimas_platform_get_time_ns();
+    return mimas_true;
+}
@@ -0,0 +1,126 @@
+#include <platform.h>
+#include <internal.h>
+#include <win/platform.h>
+#include <utils.h>
+
+#include <string.h>
+
+// Returns the name prefixed with the session namespace as a wide string that has to be freed with _mimas_free, or NULL on failure.
+static wchar_t* make_object_name(char const* const name) {
+    static wchar_t const prefix[] = L"Local\\";
+    int const prefix_length = ARRAY_SIZE(prefix) - 1;
+    int const name_size = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, name, -1, NULL, 0);
+    if(name_size == 0) {
+        return NULL;
+    }
+
+    wchar_t* const wname = (wchar_t*)_mimas_malloc(sizeof(wchar_t) * (prefix_length + name_size));
+    memcpy(wname, prefix, sizeof(wchar_t) * prefix_length);
+    MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, name, -1, wname + prefix_length, name_size);
+    return wname;
+}
+
+void* mimas_platform_create_shared_memory(char const* const name, mimas_u64 const size, void** const handle) {
+    wchar_t* const wname = make_object_name(name);
+    if(!wname) {
+        // TODO: Error
+        return NULL;
+    }
+
+    HANDLE const mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, wname);
+    DWORD const error = GetLastError();
+    _mimas_free(wname);
+    if(!mapping) {
+        // TODO: Error
+        return NULL;
+    }
+
+    // The mapping belongs to another export.
+    if(error == ERROR_ALREADY_EXISTS) {
+        CloseHandle(mapping);
+        // TODO: Error
+        return NULL;
+    }
+
+    void* const view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if(!view) {
+        CloseHandle(mapping);
+        // TODO: Error
+        return NULL;
+    }
+
+    *handle = mapping;
+    return view;
+}
+
+void* mimas_platform_open_shared_memory(char const* const name, void** const handle, mimas_u64* const size) {
+    wchar_t* const wname = make_object_name(name);
+    if(!wname) {
+        // TODO: Error
+        return NULL;
+    }
+
+    HANDLE const mapping = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, wname);
+    _mimas_free(wname);
+    if(!mapping) {
+        return NULL;
+    }
+
+    void* const view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info;
+    if(!view || VirtualQuery(view, &info, sizeof(info)) == 0) {
+        if(view) {
+            UnmapViewOfFile(view);
+        }
+        CloseHandle(mapping);
+        // TODO: Error
+        return NULL;
+    }
+
+    // The view covers the whole mapping. Its size is rounded up to whole pages.
+    *handle = mapping;
+    *size = (mimas_u64)info.RegionSize;
+    return view;
+}
+
+void mimas_platform_close_shared_memory(void* const handle, void* const view) {
+    UnmapViewOfFile(view);
+    CloseHandle((HANDLE)handle);
+}
+
+void* mimas_platform_create_named_event(char const* const name) {
+    wchar_t* const wname = make_object_name(name);
+    if(!wname) {
+        // TODO: Error
+        return NULL;
+    }
+
+    HANDLE const event = CreateEventW(NULL, FALSE, FALSE, wname);
+    _mimas_free(wname);
+    return event;
+}
+
+void* mimas_platform_open_named_event(char const* const name) {
+    wchar_t* const wname = make_object_name(name);
+    if(!wname) {
+        // TODO: Error
+        return NULL;
+    }
+
+    HANDLE const event = OpenEventW(SYNCHRONIZE | EVENT_MODIFY_STATE, FALSE, wname);
+    _mimas_free(wname);
+    return event;
+}
+
+void mimas_platform_close_named_event(void* const event) {
+    CloseHandle((HANDLE)event);
+}
+
+void mimas_platform_signal_named_event(void* const event) {
+    SetEvent((HANDLE)event);
+}
+
+mimas_bool mimas_platform_wait_named_event(void* const event, mimas_u32 const timeout_ms) {
+    DWORD const timeout = timeout_ms == MIMAS_WAIT_FOREVER ? INFINITE : timeout_ms;
+    return WaitForSingleObject((HANDLE)event, timeout) == WAIT_OBJECT_0;
+}
@@ -0,0 +1,14 @@
+#include <platform.h>
+#include <win/platform.h>
+
+mimas_u32 mimas_platform_get_thread_id() {
+    return GetCurrentThreadId();
+}
+
+mimas_u32 mimas_platform_get_process_id() {
+    return GetCurrentProcessId();
+}
+
+void mimas_platform_sleep_ms(mimas_u32 const milliseconds) {
+    Sleep(milliseconds);
+}
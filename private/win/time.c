@@ -0,0 +1,35 @@
+#include <platform.h>
+#include <win/platform.h>
+
+mimas_u64 mimas_win_qpc_to_ns(mimas_u64 const ticks) {
+    static mimas_u64 frequency = 0;
+    if(frequency == 0) {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        frequency = f.QuadPart;
+    }
+
+    // Split the conversion to avoid overflowing 64 bits.
+    return ticks / frequency * 1000000000ULL + ticks % frequency * 1000000000ULL / frequency;
+}
+
+mimas_u64 mimas_platform_get_time_ns() {
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return mimas_win_qpc_to_ns(counter.QuadPart);
+}
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+HANDLE mimas_win_create_high_resolution_timer() {
+    return CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+}
+
+mimas_bool mimas_win_set_timer(HANDLE const timer, mimas_u64 const timeout_ns) {
+    // Negative due times are relative and measured in 100 ns units.
+    LARGE_INTEGER due_time;
+    due_time.QuadPart = -(LONGLONG)(timeout_ns / 100);
+    return SetWaitableTimer(timer, &due_time, 0, NULL, NULL, FALSE);
+}
@@ -2,6 +2,8 @@
 
 #include <wingdi.h>
 
+#include <string.h>
+
 static HMODULE opengl_module = NULL;
 
 typedef void* (*PFN_wlgGetProcAddress)(char const*);
@@ -24,6 +26,40 @@ PFN_wglChoosePixelFormatARB mimas_wglChoosePixelFormatARB = NULL;
 PFN_wglSwapIntervalEXT mimas_wglSwapIntervalEXT = NULL;
 PFN_wglGetSwapIntervalEXT mimas_wglGetSwapIntervalEXT = NULL;
 
+void* mimas_wgl_get_proc_address(char const* const name) {
+    void* const proc = wglGetProcAddress(name);
+    // Besides NULL, some drivers return small integers for functions they do not export.
+    if((UINT_PTR)proc > 3 && (INT_PTR)proc != -1) {
+        return proc;
+    }
+    // wglGetProcAddress does not resolve the OpenGL 1.1 functions that opengl32.dll exports itself.
+    return (void*)GetProcAddress(opengl_module, name);
+}
+
+mimas_bool mimas_wgl_has_extension(HDC const hdc, char const* const name) {
+    if(!wglGetExtensionsStringARB) {
+        return mimas_false;
+    }
+
+    char const* const all_extensions = wglGetExtensionsStringARB(hdc);
+    if(!all_extensions) {
+        return mimas_false;
+    }
+
+    // The extensions are separated by spaces. Match whole names only so that prefixes of longer names do not count.
+    mimas_u64 const length = strlen(name);
+    char const* extensions = all_extensions;
+    while((extensions = strstr(extensions, name)) != NULL) {
+        char const* const end = extensions + length;
+        mimas_bool const starts = extensions == all_extensions || extensions[-1] == ' ';
+        if(starts && (*end == ' ' || *end == '\0')) {
+            return mimas_true;
+        }
+        extensions = end;
+    }
+    return mimas_false;
+}
+
 mimas_bool mimas_load_wgl(HDC const hdc) {
     opengl_module = LoadLibraryW(L"opengl32.dll");
     if(opengl_module) {
@@ -52,6 +88,7 @@ mimas_bool mimas_load_wgl(HDC const hdc) {
             return mimas_false;
         }
 
+        // Extension entry points are resolved through wglGetProcAddress once a context is current.
         mimas_wglGetExtensionsStringARB = (PFN_wglGetExtensionsStringARB)wglGetProcAddress("wglGetExtensionsStringARB");
         mimas_wglCreateContextAttribsARB = (PFN_wglCreateContextAttribsARB)wglGetProcAddress("wglCreateContextAttribsARB");
         mimas_wglGetPixelFormatAttribivARB = (PFN_wglGetPixelFormatAttribivARB)wglGetProcAddress("wglGetPixelFormatAttribivARB");
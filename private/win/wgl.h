@@ -10,10 +10,14 @@
 // Assumes pixel format is already set on the given HDC.
 mimas_bool mimas_load_wgl(HDC);
 void mimas_unload_wgl();
+// Resolves core and extension functions of the current context.
+void* mimas_wgl_get_proc_address(char const* name);
+// Whether the WGL extension name is supported on hdc.
+mimas_bool mimas_wgl_has_extension(HDC, char const* name);
 
 typedef char const* (*PFN_wglGetExtensionsStringARB)(HDC);
 extern PFN_wglGetExtensionsStringARB mimas_wglGetExtensionsStringARB;
-#define wglGetExtensionsStringARB mimas_wglGetExtensionsStringARB;
+#define wglGetExtensionsStringARB mimas_wglGetExtensionsStringARB
 
 
 typedef HGLRC (*PFN_wglCreateContext)(HDC);
@@ -57,6 +61,23 @@ extern PFN_wglCreateContextAttribsARB mimas_wglCreateContextAttribsARB;
 #define wglCreateContextAttribsARB mimas_wglCreateContextAttribsARB
 
 
+// WGL_ARB_create_context_robustness
+#define WGL_CONTEXT_ROBUST_ACCESS_BIT_ARB           0x00000004
+#define WGL_CONTEXT_RESET_NOTIFICATION_STRATEGY_ARB 0x8256
+#define WGL_NO_RESET_NOTIFICATION_ARB               0x8261
+#define WGL_LOSE_CONTEXT_ON_RESET_ARB               0x8252
+
+
+// WGL_ARB_create_context_no_error
+#define WGL_CONTEXT_OPENGL_NO_ERROR_ARB             0x31B3
+
+
+// WGL_ARB_context_flush_control
+#define WGL_CONTEXT_RELEASE_BEHAVIOR_ARB            0x2097
+#define WGL_CONTEXT_RELEASE_BEHAVIOR_NONE_ARB       0
+#define WGL_CONTEXT_RELEASE_BEHAVIOR_FLUSH_ARB      0x2098
+
+
 // WGL_ARB_pixel_format
 #define WGL_NUMBER_PIXEL_FORMATS_ARB      0x2000
 #define WGL_DRAW_TO_WINDOW_ARB            0x2001
@@ -118,6 +139,15 @@ extern PFN_wglChoosePixelFormatARB mimas_wglChoosePixelFormatARB;
 #define wglChoosePixelFormatARB mimas_wglChoosePixelFormatARB
 
 
+// WGL_ARB_multisample
+#define WGL_SAMPLE_BUFFERS_ARB            0x2041
+#define WGL_SAMPLES_ARB                   0x2042
+
+
+// WGL_ARB_framebuffer_sRGB and WGL_EXT_framebuffer_sRGB
+#define WGL_FRAMEBUFFER_SRGB_CAPABLE_ARB  0x20A9
+
+
 // WGL_EXT_swap_control
 typedef BOOL (WINAPI* PFN_wglSwapIntervalEXT)(int interval);
 typedef int (WINAPI* PFN_wglGetSwapIntervalEXT)(void);
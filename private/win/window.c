@@ -5,6 +5,9 @@
 #include <utils.h>
 #include <platform_gl.h>
 #include <platform_vk.h>
+#include <instrument.h>
+#include <win/wgl.h>
+#include <atomic.h>
 
 #include <wingdi.h>
 
@@ -25,11 +28,7 @@ static mimas_u32 get_window_extended_styles(Mimas_Window const* const window) {
 //
 static void capture_cursor(Mimas_Window* const window) {
     Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
-    RECT client;
-    GetClientRect(native_window->handle, &client);
-    ClientToScreen(native_window->handle, (POINT*)&client.left);
-    ClientToScreen(native_window->handle, (POINT*)&client.right);
-    ClipCursor(&client);
+    ClipCursor(&native_window->client_rect);
 }
 
 static void release_captured_cursor() {
@@ -46,6 +45,94 @@ static void disable_virtual_cursor(Mimas_Window* const window) {
     release_captured_cursor();
 }
 
+static void update_window_geometry(Mimas_Win_Window* const native_window) {
+    GetWindowRect(native_window->handle, &native_window->window_rect);
+    GetClientRect(native_window->handle, &native_window->client_rect);
+    ClientToScreen(native_window->handle, (POINT*)&native_window->client_rect.left);
+    ClientToScreen(native_window->handle, (POINT*)&native_window->client_rect.right);
+}
+
+static void update_window_visibility(Mimas_Window* const window) {
+    HWND const hwnd = ((Mimas_Win_Window*)window->native_window)->handle;
+    if(!IsWindowVisible(hwnd)) {
+        _mimas_window_visibility_changed(window, MIMAS_WINDOW_HIDDEN);
+    } else if(IsIconic(hwnd)) {
+        _mimas_window_visibility_changed(window, MIMAS_WINDOW_MINIMIZED);
+    } else {
+        // DWM cloaks windows on other virtual desktops and suspended UWP-style windows without moving or hiding them.
+        DWORD cloaked = 0;
+        DwmGetWindowAttribute(hwnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked));
+        _mimas_window_visibility_changed(window, cloaked ? MIMAS_WINDOW_OCCLUDED : MIMAS_WINDOW_VISIBLE);
+    }
+}
+
+static mimas_bool set_display_mode(Mimas_Win_Window* const native_window) {
+    if(ChangeDisplaySettingsExW(native_window->display_device, &native_window->display_mode, NULL, CDS_FULLSCREEN, NULL) != DISP_CHANGE_SUCCESSFUL) {
+        return mimas_false;
+    }
+
+    native_window->display_mode_set = mimas_true;
+    mimas_win_invalidate_monitors();
+    return mimas_true;
+}
+
+static void reset_display_mode(Mimas_Win_Window* const native_window) {
+    if(!native_window->display_mode_set) {
+        return;
+    }
+
+    // NULL goes back to the mode stored in the registry, i.e. the one the user has chosen.
+    ChangeDisplaySettingsExW(native_window->display_device, NULL, NULL, CDS_FULLSCREEN, NULL);
+    native_window->display_mode_set = mimas_false;
+    mimas_win_invalidate_monitors();
+}
+
+// The bounds of the monitor change with its video mode, therefore we query them every time.
+static void cover_fullscreen_monitor(Mimas_Win_Window* const native_window) {
+    MONITORINFO info = {.cbSize = sizeof(MONITORINFO)};
+    if(!GetMonitorInfoW(native_window->fullscreen_monitor, &info)) {
+        return;
+    }
+
+    RECT const rect = info.rcMonitor;
+    SetWindowPos(native_window->handle, HWND_TOP, rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top, SWP_FRAMECHANGED | SWP_NOOWNERZORDER | SWP_NOACTIVATE);
+}
+
+static mimas_u64 take_injected_key_time(Mimas_Win_Window* const native_window) {
+    mimas_u64 const timestamp_ns = _mimas_atomic_load_u64(&native_window->injected_key_ns);
+    if(timestamp_ns == 0 || !_mimas_atomic_cas_u64(&native_window->injected_key_ns, timestamp_ns, 0)) {
+        return 0;
+    }
+    return timestamp_ns;
+}
+
+// Records the cursor position and requests a leave notification so that we know when the position goes stale.
+static void track_cursor(Mimas_Win_Window* const native_window, mimas_i32 const x, mimas_i32 const y, Mimas_Win_Mouse_Tracking const tracking) {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    platform->cursor_window = native_window->handle;
+    platform->cursor_x = x;
+    platform->cursor_y = y;
+
+    if(native_window->mouse_tracking != tracking) {
+        TRACKMOUSEEVENT tme = {
+            .cbSize = sizeof(TRACKMOUSEEVENT),
+            .dwFlags = TME_LEAVE | (tracking == MIMAS_WIN_MOUSE_TRACKING_NONCLIENT ? TME_NONCLIENT : 0),
+            .hwndTrack = native_window->handle,
+        };
+        if(TrackMouseEvent(&tme)) {
+            native_window->mouse_tracking = tracking;
+        }
+    }
+}
+
+static void untrack_cursor(Mimas_Win_Window* const native_window) {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    native_window->mouse_tracking = MIMAS_WIN_MOUSE_TRACKING_NONE;
+    if(platform->cursor_window == native_window->handle) {
+        platform->cursor_window = NULL;
+    }
+}
+
 static mimas_i32 window_hit_test(mimas_i32 const cursor_x, mimas_i32 const cursor_y, RECT const window_rect) {
     enum Region_Mask {
         client = 0, 
@@ -92,19 +179,82 @@ static Mimas_Key translate_key(mimas_u32 const vk, mimas_bool const extended) {
     }
 }
 
-static LRESULT window_proc(HWND const hwnd, UINT const msg, WPARAM const wparam, LPARAM const lparam) {
+static char const* message_name(UINT const msg) {
+    switch(msg) {
+        case WM_ACTIVATE: return "WM_ACTIVATE";
+        case WM_NCCALCSIZE: return "WM_NCCALCSIZE";
+        case WM_NCHITTEST: return "WM_NCHITTEST";
+        case WM_SETFOCUS: return "WM_SETFOCUS";
+        case WM_KILLFOCUS: return "WM_KILLFOCUS";
+        case WM_KEYUP: return "WM_KEYUP";
+        case WM_KEYDOWN: return "WM_KEYDOWN";
+        case WM_CHAR: return "WM_CHAR";
+        case WM_UNICHAR: return "WM_UNICHAR";
+        case WM_LBUTTONDOWN: return "WM_LBUTTONDOWN";
+        case WM_MBUTTONDOWN: return "WM_MBUTTONDOWN";
+        case WM_RBUTTONDOWN: return "WM_RBUTTONDOWN";
+        case WM_XBUTTONDOWN: return "WM_XBUTTONDOWN";
+        case WM_LBUTTONUP: return "WM_LBUTTONUP";
+        case WM_MBUTTONUP: return "WM_MBUTTONUP";
+        case WM_RBUTTONUP: return "WM_RBUTTONUP";
+        case WM_XBUTTONUP: return "WM_XBUTTONUP";
+        case WM_MOUSEMOVE: return "WM_MOUSEMOVE";
+        case WM_NCMOUSEMOVE: return "WM_NCMOUSEMOVE";
+        case WM_MOUSELEAVE: return "WM_MOUSELEAVE";
+        case WM_NCMOUSELEAVE: return "WM_NCMOUSELEAVE";
+        case WM_WINDOWPOSCHANGED: return "WM_WINDOWPOSCHANGED";
+        case WM_CLOSE: return "WM_CLOSE";
+        case WM_PAINT: return "WM_PAINT";
+        case WM_SIZE: return "WM_SIZE";
+        case WM_MOVE: return "WM_MOVE";
+        case WM_DPICHANGED: return "WM_DPICHANGED";
+        case WM_TIMER: return "WM_TIMER";
+        case WM_ENTERSIZEMOVE: return "WM_ENTERSIZEMOVE";
+        case WM_EXITSIZEMOVE: return "WM_EXITSIZEMOVE";
+        default: return "window_proc";
+    }
+}
+
+// The process is per-monitor DPI aware, so the system reports sizes in physical pixels. Content sizes are logical units,
+//   which keep the window at the same apparent size on monitors with different scales.
+static mimas_i32 pixels_to_logical(Mimas_Window const* const window, mimas_i32 const pixels) {
+    return window->content_scale > 0.0f ? (mimas_i32)(pixels / window->content_scale + 0.5f) : pixels;
+}
+
+static mimas_i32 logical_to_pixels(Mimas_Window const* const window, mimas_i32 const logical) {
+    return window->content_scale > 0.0f ? (mimas_i32)(logical * window->content_scale + 0.5f) : logical;
+}
+
+static LRESULT handle_window_message(HWND const hwnd, UINT const msg, WPARAM const wparam, LPARAM const lparam) {
     Mimas_Window* const window = GetPropW(hwnd, L"Mimas_Window");
+    // Messages sent during CreateWindowEx arrive before the window has been associated with the hwnd.
+    if(!window) {
+        return DefWindowProc(hwnd, msg, wparam, lparam);
+    }
+
+    _mimas_stats_count_window_event(window);
+
     switch(msg) {
         case WM_ACTIVATE: {
-            if(!window->decorated) {
+            if(window->fullscreen == MIMAS_FULLSCREEN_EXCLUSIVE) {
+                Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+                if(LOWORD(wparam) == WA_INACTIVE) {
+                    // Give the monitor back to the desktop while another window is active.
+                    reset_display_mode(native_window);
+                    ShowWindow(hwnd, SW_MINIMIZE);
+                } else if(native_window->display_mode.dmFields != 0 && !native_window->display_mode_set && set_display_mode(native_window)) {
+                    cover_fullscreen_monitor(native_window);
+                }
+            } else if(!window->decorated && window->fullscreen == MIMAS_WINDOWED) {
+                // Not for fullscreen windows, where the frame would keep DWM from presenting them directly.
                 MARGINS const margins = {1, 1, 1, 1};
                 DwmExtendFrameIntoClientArea(hwnd, &margins);
                 SetWindowPos(hwnd, NULL, 0, 0, 0, 0, SWP_FRAMECHANGED | SWP_NOSIZE | SWP_NOMOVE | SWP_NOZORDER);
             }
 
             LRESULT const res = DefWindowProc(hwnd, msg, wparam, lparam);
-            if(window->callbacks.window_activate) {
-                window->callbacks.window_activate(window, wparam != 0, window->callbacks.window_activate_data);
+            if(window->callbacks.window_activate && (window->event_mask & MIMAS_EVENT_MASK_ACTIVATE)) {
+                _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_WINDOW_ACTIVATE, window->callbacks.window_activate(window, wparam != 0, window->callbacks.window_activate_data));
             }
             return res;
         } break;
@@ -116,16 +266,18 @@ static LRESULT window_proc(HWND const hwnd, UINT const msg, WPARAM const wparam,
         } break;
 
         case WM_NCHITTEST: {
-            RECT window_rect;
-            GetWindowRect(hwnd, &window_rect);
-            RECT client_rect;
-            GetClientRect(hwnd, &client_rect);
-            ClientToScreen(hwnd, (POINT*)&client_rect.left);
-            ClientToScreen(hwnd, (POINT*)&client_rect.right);
+            if(window->fullscreen != MIMAS_WINDOWED) {
+                return HTCLIENT;
+            }
+
+            Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+            RECT const window_rect = native_window->window_rect;
+            RECT const client_rect = native_window->client_rect;
             if(window->callbacks.hittest) {
                 Mimas_Rect const _window_rect = {window_rect.left, window_rect.top, window_rect.bottom, window_rect.right};
                 Mimas_Rect const _client_rect = {client_rect.left, client_rect.top, client_rect.bottom, client_rect.right};
-                Mimas_Hittest_Result const r = window->callbacks.hittest(window, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam), _window_rect, _client_rect);
+                Mimas_Hittest_Result r;
+                _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_HITTEST, r = window->callbacks.hittest(window, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam), _window_rect, _client_rect));
                 mimas_i32 const hit[] = {
                     [MIMAS_HITTEST_TOP] = HTTOP,
                     [MIMAS_HITTEST_BOTTOM] = HTBOTTOM,
@@ -155,8 +307,8 @@ static LRESULT window_proc(HWND const hwnd, UINT const msg, WPARAM const wparam,
                 enable_virtual_cursor(window);
             }
 
-            if(window->callbacks.window_activate) {
-                window->callbacks.window_activate(window, mimas_true, window->callbacks.window_activate_data);
+            if(window->callbacks.window_activate && (window->event_mask & MIMAS_EVENT_MASK_ACTIVATE)) {
+                _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_WINDOW_ACTIVATE, window->callbacks.window_activate(window, mimas_true, window->callbacks.window_activate_data));
             }
         } break;
 
@@ -167,24 +319,31 @@ static LRESULT window_proc(HWND const hwnd, UINT const msg, WPARAM const wparam,
                 disable_virtual_cursor(window);
             }
 
-            if(window->callbacks.key) {
+            if(window->callbacks.key && (window->event_mask & MIMAS_EVENT_MASK_KEY)) {
                 for(mimas_u32 i = 0; i < ARRAY_SIZE(window->keys); ++i) {
                     if(window->keys[i] != MIMAS_KEY_RELEASE) {
                         window->keys[i] = MIMAS_KEY_RELEASE;
-                        window->callbacks.key(window, i, MIMAS_KEY_RELEASE, window->callbacks.key_data);
+                        _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_KEY, window->callbacks.key(window, i, MIMAS_KEY_RELEASE, window->callbacks.key_data));
                     }
                 }
             }
 
-            if(window->callbacks.window_activate) {
-                window->callbacks.window_activate(window, mimas_false, window->callbacks.window_activate_data);
+            if(window->callbacks.window_activate && (window->event_mask & MIMAS_EVENT_MASK_ACTIVATE)) {
+                _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_WINDOW_ACTIVATE, window->callbacks.window_activate(window, mimas_false, window->callbacks.window_activate_data));
             }
         } break;
 
         case WM_KEYUP:
         case WM_KEYDOWN: {
-            mimas_bool const extended = lparam & 0x800000;
-            mimas_bool const key_was_up = lparam & 0x80000000;
+            // Taken before the mask check so that a masked key does not leave its time to the next injected key.
+            mimas_u64 const injected_ns = (lparam & MIMAS_WIN_INJECTED_KEY) ? take_injected_key_time((Mimas_Win_Window*)window->native_window) : 0;
+            if(!(window->event_mask & MIMAS_EVENT_MASK_KEY)) {
+                break;
+            }
+
+            mimas_bool const extended = (HIWORD(lparam) & KF_EXTENDED) != 0;
+            // Bit 30 is the state of the key before the message.
+            mimas_bool const key_was_up = !(lparam & 0x40000000);
             Mimas_Key const key = translate_key(wparam, extended);
             Mimas_Key_Action action;
             if(key_was_up && msg == WM_KEYDOWN) {
@@ -196,10 +355,50 @@ static LRESULT window_proc(HWND const hwnd, UINT const msg, WPARAM const wparam,
             }
 
             window->keys[key] = action;
+            _mimas_stats_count_input(window, injected_ns);
 
             if(window->callbacks.key) {
-                window->callbacks.key(window, key, action, window->callbacks.key_data);
+                _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_KEY, window->callbacks.key(window, key, action, window->callbacks.key_data));
+            }
+        } break;
+
+        case WM_CHAR: {
+            if(!(window->event_mask & MIMAS_EVENT_MASK_TEXT)) {
+                return 0;
+            }
+
+            Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+            WCHAR const c = (WCHAR)wparam;
+            if(IS_HIGH_SURROGATE(c)) {
+                native_window->high_surrogate = c;
+                return 0;
             }
+
+            mimas_u32 codepoint = c;
+            if(IS_LOW_SURROGATE(c)) {
+                if(!native_window->high_surrogate) {
+                    return 0;
+                }
+                codepoint = 0x10000 + ((native_window->high_surrogate - 0xD800) << 10) + (c - 0xDC00);
+            }
+            native_window->high_surrogate = 0;
+
+            if(codepoint >= 0x20 && codepoint != 0x7F) {
+                _mimas_append_text_input(window, codepoint);
+            }
+            return 0;
+        } break;
+
+        case WM_UNICHAR: {
+            // Returning TRUE for UNICODE_NOCHAR tells the sender that we accept UTF-32 characters.
+            if(wparam == UNICODE_NOCHAR) {
+                return TRUE;
+            }
+
+            if(wparam >= 0x20 && wparam != 0x7F) {
+                _mimas_append_text_input(window, (mimas_u32)wparam);
+            }
+            return 0;
         } break;
 
         case WM_LBUTTONDOWN:
@@ -210,7 +409,8 @@ static LRESULT window_proc(HWND const hwnd, UINT const msg, WPARAM const wparam,
         case WM_MBUTTONUP:
         case WM_RBUTTONUP:
         case WM_XBUTTONUP: {
-            if(window->callbacks.mouse_button) {
+            if(window->callbacks.mouse_button && (window->event_mask & MIMAS_EVENT_MASK_MOUSE_BUTTON)) {
+                _mimas_stats_count_input(window, 0);
                 Mimas_Mouse_Button_Action const action = (msg == WM_LBUTTONUP || msg == WM_MBUTTONUP || msg == WM_RBUTTONUP || msg == WM_XBUTTONUP);
                 mimas_bool const is_lmb = (msg == WM_LBUTTONUP || msg == WM_LBUTTONDOWN);
                 mimas_bool const is_rmb = (msg == WM_RBUTTONUP || msg == WM_RBUTTONDOWN);
@@ -219,7 +419,7 @@ static LRESULT window_proc(HWND const hwnd, UINT const msg, WPARAM const wparam,
                 Mimas_Mouse_Button const button = MIMAS_MOUSE_BUTTON_LEFT * is_lmb | MIMAS_MOUSE_BUTTON_RIGHT * is_rmb | MIMAS_MOUSE_BUTTON_MIDDLE * is_mmb;
                 // TODO: Temporarily because we don't have enough buttons.
                 if(is_lmb || is_rmb || is_mmb) {
-                    window->callbacks.mouse_button(window, button, action, window->callbacks.mouse_button_data);
+                    _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_MOUSE_BUTTON, window->callbacks.mouse_button(window, button, action, window->callbacks.mouse_button_data));
                 }
             }
 
@@ -227,13 +427,99 @@ static LRESULT window_proc(HWND const hwnd, UINT const msg, WPARAM const wparam,
         } break;
 
         case WM_MOUSEMOVE: {
+            Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+            // Without tracking, mimas_get_cursor_pos asks the system instead of using the cache.
+            if(!(window->event_mask & MIMAS_EVENT_MASK_CURSOR_POS)) {
+                untrack_cursor(native_window);
+                return 0;
+            }
+
             mimas_i32 const x = GET_X_LPARAM(lparam);
             mimas_i32 const y = GET_Y_LPARAM(lparam);
+            track_cursor(native_window, native_window->client_rect.left + x, native_window->client_rect.top + y, MIMAS_WIN_MOUSE_TRACKING_CLIENT);
+            _mimas_stats_count_input(window, 0);
 
             if(window->callbacks.cursor_pos) {
-                window->callbacks.cursor_pos(window, x, y, window->callbacks.cursor_pos_data);
+                _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_CURSOR_POS, window->callbacks.cursor_pos(window, x, y, window->callbacks.cursor_pos_data));
+            }
+
+            return 0;
+        } break;
+
+        case WM_NCMOUSEMOVE: {
+            if(!(window->event_mask & MIMAS_EVENT_MASK_CURSOR_POS)) {
+                untrack_cursor((Mimas_Win_Window*)window->native_window);
+                break;
             }
 
+            // Non-client coordinates are already in screen space.
+            track_cursor((Mimas_Win_Window*)window->native_window, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam), MIMAS_WIN_MOUSE_TRACKING_NONCLIENT);
+        } break;
+
+        case WM_MOUSELEAVE:
+        case WM_NCMOUSELEAVE: {
+            untrack_cursor((Mimas_Win_Window*)window->native_window);
+            return 0;
+        } break;
+
+        case WM_WINDOWPOSCHANGED: {
+            update_window_geometry((Mimas_Win_Window*)window->native_window);
+            // Showing, hiding, minimizing and restoring all go through here.
+            update_window_visibility(window);
+            // DefWindowProc generates WM_SIZE and WM_MOVE from this message.
+        } break;
+
+        case WM_SIZE: {
+            // Minimized windows report a size of 0x0. The window keeps its size, and the minimization is reported as a visibility change.
+            if(wparam == SIZE_MINIMIZED) {
+                break;
+            }
+
+            mimas_i32 const width = LOWORD(lparam);
+            mimas_i32 const height = HIWORD(lparam);
+            _mimas_window_resized(window, pixels_to_logical(window, width), pixels_to_logical(window, height), width, height);
+
+            // The modal resize loop does not return to mimas_poll_events until the user is done resizing.
+            // Without an interval we report every size change, otherwise the resize timer reports them.
+            Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+            if(native_window->in_size_move && window->resize.interval_ms == 0) {
+                _mimas_dispatch_resize(window);
+            }
+        } break;
+
+        case WM_ENTERSIZEMOVE: {
+            Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+            native_window->in_size_move = mimas_true;
+            if(window->resize.interval_ms > 0) {
+                SetTimer(hwnd, MIMAS_RESIZE_TIMER_ID, window->resize.interval_ms, NULL);
+            }
+        } break;
+
+        case WM_EXITSIZEMOVE: {
+            Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+            native_window->in_size_move = mimas_false;
+            KillTimer(hwnd, MIMAS_RESIZE_TIMER_ID);
+            _mimas_dispatch_resize(window);
+        } break;
+
+        case WM_TIMER: {
+            if(wparam == MIMAS_RESIZE_TIMER_ID) {
+                _mimas_dispatch_resize(window);
+                return 0;
+            }
+        } break;
+
+        case WM_DPICHANGED: {
+            // Also sent when the scale of a monitor is changed in the display settings.
+            mimas_win_invalidate_monitors();
+            window->content_scale = (float)LOWORD(wparam) / USER_DEFAULT_SCREEN_DPI;
+            // Windows suggests a rect that keeps the window at the same physical size on the new monitor.
+            RECT const* const suggested = (RECT const*)lparam;
+            SetWindowPos(hwnd, NULL, suggested->left, suggested->top, suggested->right - suggested->left, suggested->bottom - suggested->top, SWP_NOZORDER | SWP_NOACTIVATE);
+
+            if(window->callbacks.content_scale && (window->event_mask & MIMAS_EVENT_MASK_CONTENT_SCALE)) {
+                _MIMAS_INVOKE_CALLBACK(window, MIMAS_CALLBACK_CONTENT_SCALE, window->callbacks.content_scale(window, window->content_scale, window->content_scale, window->callbacks.content_scale_data));
+            }
             return 0;
         } break;
 
@@ -246,6 +532,46 @@ static LRESULT window_proc(HWND const hwnd, UINT const msg, WPARAM const wparam,
     return DefWindowProc(hwnd, msg, wparam, lparam);
 }
 
+static LRESULT window_proc(HWND const hwnd, UINT const msg, WPARAM const wparam, LPARAM const lparam) {
+    // The trace arg is the message id so that messages we do not name can still be told apart.
+    char const* const name = message_name(msg);
+    _mimas_trace_begin_with_arg(name, msg);
+    LRESULT const res = handle_window_message(hwnd, msg, wparam, lparam);
+    _mimas_trace_end(name);
+    return res;
+}
+
+static LRESULT helper_window_proc(HWND const hwnd, UINT const msg, WPARAM const wparam, LPARAM const lparam) {
+    switch(msg) {
+        case WM_RENDERFORMAT: {
+            mimas_win_render_clipboard_format((UINT)wparam);
+            return 0;
+        } break;
+
+        case WM_RENDERALLFORMATS: {
+            mimas_win_render_all_clipboard_formats();
+            return 0;
+        } break;
+
+        case WM_DESTROYCLIPBOARD: {
+            mimas_win_release_clipboard();
+            return 0;
+        } break;
+
+        case WM_DISPLAYCHANGE: {
+            mimas_win_invalidate_monitors();
+        } break;
+
+        case WM_SETTINGCHANGE: {
+            if(wparam == SPI_SETWORKAREA) {
+                mimas_win_invalidate_monitors();
+            }
+        } break;
+    }
+
+    return DefWindowProc(hwnd, msg, wparam, lparam);
+}
+
 // Returns 1 if succeeded, 0 otherwise
 static mimas_bool register_window_class() {
     WNDCLASSEX wndclass = {
@@ -257,29 +583,86 @@ static mimas_bool register_window_class() {
         .lpszClassName = MIMAS_WINDOW_CLASS_NAME,
         .hInstance = NULL,
     };
-    return RegisterClassEx(&wndclass);
+    if(!RegisterClassEx(&wndclass)) {
+        return mimas_false;
+    }
+
+    WNDCLASSEX helper_wndclass = {
+        .cbSize = sizeof(WNDCLASSEX),
+        .lpfnWndProc = helper_window_proc,
+        .lpszClassName = MIMAS_HELPER_WINDOW_CLASS_NAME,
+        .hInstance = NULL,
+    };
+    if(!RegisterClassEx(&helper_wndclass)) {
+        UnregisterClass(MIMAS_WINDOW_CLASS_NAME, NULL);
+        return mimas_false;
+    }
+
+    return mimas_true;
 }
 
 // Returns 1 if succeeded, 0 otherwise.
 static mimas_bool unregister_window_class() {
-    return UnregisterClass(MIMAS_WINDOW_CLASS_NAME, NULL);
+    mimas_bool const helper_res = UnregisterClass(MIMAS_HELPER_WINDOW_CLASS_NAME, NULL);
+    mimas_bool const res = UnregisterClass(MIMAS_WINDOW_CLASS_NAME, NULL);
+    return helper_res && res;
+}
+
+static Mimas_Framebuffer_Config const default_framebuffer_config = {
+    .red_bits = 8,
+    .green_bits = 8,
+    .blue_bits = 8,
+    .alpha_bits = 8,
+    .depth_bits = 24,
+    .stencil_bits = 8,
+    .samples = 0,
+    .srgb = mimas_false,
+    .buffer_count = 2,
+};
+
+static mimas_bool set_pixel_format(HDC const hdc, Mimas_Framebuffer_Config const* const config) {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    // Before the GL backend is initialized only the legacy path is available. Its choice does not honour the whole config,
+    //   so it is not reused once wglChoosePixelFormatARB has been loaded.
+    mimas_bool const arb = wglChoosePixelFormatARB != NULL;
+    int pixel_format = 0;
+    if(platform->pixel_format && platform->pixel_format_arb == arb && memcmp(&platform->pixel_format_config, config, sizeof(Mimas_Framebuffer_Config)) == 0) {
+        pixel_format = platform->pixel_format;
+    } else {
+        pixel_format = mimas_win_choose_pixel_format(hdc, config);
+        if(!pixel_format) {
+            // TODO: Error
+            return mimas_false;
+        }
+
+        platform->pixel_format = pixel_format;
+        platform->pixel_format_arb = arb;
+        platform->pixel_format_config = *config;
+    }
+
+    PIXELFORMATDESCRIPTOR pfd;
+    if(!DescribePixelFormat(hdc, pixel_format, sizeof(PIXELFORMATDESCRIPTOR), &pfd)) {
+        // TODO: Error
+        return mimas_false;
+    }
+    return SetPixelFormat(hdc, pixel_format, &pfd);
 }
 
 static Mimas_Window* create_native_window(Mimas_Window_Create_Info const info) {
-    Mimas_Window* const window = (Mimas_Window*)malloc(sizeof(Mimas_Window));
+    Mimas_Window* const window = (Mimas_Window*)_mimas_malloc(sizeof(Mimas_Window));
     memset(window, 0, sizeof(Mimas_Window));
 
     window->decorated = info.decorated;
 
     mimas_u32 const style = WS_CLIPSIBLINGS | WS_CLIPCHILDREN | WS_POPUP | WS_THICKFRAME | WS_CAPTION | WS_SYSMENU | WS_MAXIMIZEBOX | WS_MINIMIZEBOX;
     int const wtitle_buffer_size = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, info.title, -1, NULL, 0);
-    wchar_t* wtitle = malloc(sizeof(wchar_t) * wtitle_buffer_size);
+    wchar_t* wtitle = _mimas_malloc(sizeof(wchar_t) * wtitle_buffer_size);
     MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, info.title, -1, wtitle, wtitle_buffer_size);
     HWND const hwnd = CreateWindowEx(WS_EX_APPWINDOW, MIMAS_WINDOW_CLASS_NAME, wtitle, style, CW_USEDEFAULT, CW_USEDEFAULT, info.width, info.height, NULL, NULL, NULL, NULL);
-    free(wtitle);
+    _mimas_free(wtitle);
 
     if(!hwnd) {
-        free(window);
+        _mimas_free(window);
         // TODO: Error
         return NULL;
     }
@@ -287,34 +670,24 @@ static Mimas_Window* create_native_window(Mimas_Window_Create_Info const info) {
     Mimas_Internal* const _mimas = _mimas_get_mimas_internal();
     HDC const hdc = GetDC(hwnd);
     if(_mimas->backend == MIMAS_BACKEND_GL) {
-        PIXELFORMATDESCRIPTOR pfd = {
-            .nSize = sizeof(PIXELFORMATDESCRIPTOR),
-            .nVersion = 1,
-            .dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER,
-            .iPixelType = PFD_TYPE_RGBA,
-            .cColorBits = 24,
-            .cRedBits = 8,
-            .cGreenBits = 8,
-            .cBlueBits = 8,
-            .cAlphaBits = 8,
-            .cDepthBits = 24,
-            .cStencilBits = 8,
-        };
-        int const pixf = ChoosePixelFormat(hdc, &pfd);
-        if(!SetPixelFormat(hdc, pixf, &pfd)) {
+        Mimas_Framebuffer_Config const* const config = info.framebuffer_config ? info.framebuffer_config : &default_framebuffer_config;
+        if(!set_pixel_format(hdc, config)) {
             DestroyWindow(hwnd);
-            free(window);
+            _mimas_free(window);
             // TODO: Error
             return NULL;
         }
     }
 
-    Mimas_Win_Window* native_window = (Mimas_Win_Window*)malloc(sizeof(Mimas_Win_Window));
+    Mimas_Win_Window* native_window = (Mimas_Win_Window*)_mimas_malloc(sizeof(Mimas_Win_Window));
+    memset(native_window, 0, sizeof(Mimas_Win_Window));
     native_window->handle = hwnd;
     native_window->hdc = hdc;
     window->native_window = native_window;
 
     SetProp(hwnd, L"Mimas_Window", (HANDLE)window);
+    update_window_geometry(native_window);
+    window->content_scale = (float)mimas_win_get_window_dpi(hwnd) / USER_DEFAULT_SCREEN_DPI;
 
     if(!info.decorated) {
         MARGINS const margins = {1, 1, 1, 1};
@@ -327,13 +700,69 @@ static Mimas_Window* create_native_window(Mimas_Window_Create_Info const info) {
 
 static void destroy_native_window(Mimas_Window* const window) {
     Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+    untrack_cursor(native_window);
+    reset_display_mode(native_window);
     DestroyWindow(native_window->handle);
-    free(native_window);
-    free(window);
+    _mimas_free(native_window);
+    _mimas_free(window);
+}
+
+static void set_window_title(HWND const hwnd, char const* const title) {
+    int const wtitle_buffer_size = MultiByteToWideChar(CP_UTF8, 0, title, -1, NULL, 0);
+    wchar_t* const wtitle = _mimas_malloc(sizeof(wchar_t) * wtitle_buffer_size);
+    MultiByteToWideChar(CP_UTF8, 0, title, -1, wtitle, wtitle_buffer_size);
+    SetWindowTextW(hwnd, wtitle);
+    _mimas_free(wtitle);
+}
+
+// The frame change takes effect on the next SetWindowPos with SWP_FRAMECHANGED.
+static void set_window_decorated(Mimas_Window* const window, mimas_bool const decorated) {
+    Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+    window->decorated = decorated;
+    MARGINS const margins = decorated ? (MARGINS){0, 0, 0, 0} : (MARGINS){1, 1, 1, 1};
+    DwmExtendFrameIntoClientArea(native_window->handle, &margins);
+}
+
+// Pooled windows are created with the default title and decorations and reconfigured when they are handed out.
+static Mimas_Window_Create_Info const pooled_window_info = {.width = 1280, .height = 720, .title = "", .decorated = mimas_true};
+
+// Creates at most max_windows windows. Stops at the first window that fails to be created.
+static void fill_window_pool(Mimas_Win_Window_Pool* const pool, mimas_u32 const max_windows) {
+    for(mimas_u32 i = 0; i < max_windows && pool->count < pool->size; ++i) {
+        Mimas_Window* const window = create_native_window(pooled_window_info);
+        if(!window) {
+            // TODO: Error
+            return;
+        }
+        pool->windows[pool->count] = window;
+        pool->count += 1;
+    }
+}
+
+// Creates the hidden window that GL contexts are created for unless the user passes a window.
+static Mimas_Window* create_dummy_window() {
+    Mimas_Window* const dummy_window = create_native_window((Mimas_Window_Create_Info){.width = 1280, .height = 720, .title = "MIMAS_HELPER_WINDOW", .decorated = mimas_false});
+    if(!dummy_window) {
+        return NULL;
+    }
+
+    HWND const dummy_hwnd = ((Mimas_Win_Window*)dummy_window->native_window)->handle;
+    // If the program is launched with STARTUPINFO, the first call to ShowWindow will ignore the nCmdShow param,
+    //   therefore we call it here to clear that behaviour...
+    ShowWindow(dummy_hwnd, SW_HIDE);
+    // ... and call it again to make sure it's hidden.
+    ShowWindow(dummy_hwnd, SW_HIDE);
+
+    MSG msg;
+    while (PeekMessageW(&msg, dummy_hwnd, 0, 0, PM_REMOVE)) {
+        TranslateMessage(&msg);
+        DispatchMessageW(&msg);
+    }
+    return dummy_window;
 }
 
-mimas_bool mimas_platform_init() {
-    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)malloc(sizeof(Mimas_Win_Platform));
+mimas_bool mimas_win_platform_init(Mimas_Backend const backend) {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_malloc(sizeof(Mimas_Win_Platform));
     memset(platform, 0, sizeof(Mimas_Win_Platform));
     memset(platform->keys, -1, sizeof(platform->keys));
 
@@ -392,170 +821,526 @@ mimas_bool mimas_platform_init() {
     platform->keys[VK_RETURN] = MIMAS_KEY_ENTER;
     platform->keys[VK_ESCAPE] = MIMAS_KEY_ESCAPE;
 
+    // Manual-reset so that any number of waiters observe the wakeup until the events are dispatched.
+    platform->event = CreateEventW(NULL, TRUE, FALSE, NULL);
+    if(!platform->event) {
+        _mimas_free(platform);
+        return mimas_false;
+    }
+
     mimas_bool const register_res = register_window_class();
     if(!register_res) {
+        CloseHandle(platform->event);
+        _mimas_free(platform);
         return mimas_false;
     }
     Mimas_Internal* const _mimas = _mimas_get_mimas_internal();
+    _mimas->platform = platform;
+    mimas_win_init_dpi(platform);
+    platform->monitors.dirty = mimas_true;
+
+    // The helper window is a hidden top-level window rather than a message-only window
+    // so that it also receives broadcast messages.
+    platform->helper_window = CreateWindowEx(WS_EX_TOOLWINDOW, MIMAS_HELPER_WINDOW_CLASS_NAME, L"MIMAS_HELPER_WINDOW", WS_POPUP, 0, 0, 1, 1, NULL, NULL, NULL, NULL);
+    if(!platform->helper_window) {
+        mimas_win_terminate_dpi(platform);
+        unregister_window_class();
+        _mimas->platform = NULL;
+        CloseHandle(platform->event);
+        _mimas_free(platform);
+        return mimas_false;
+    }
 
-    if(_mimas->backend == MIMAS_BACKEND_GL) {
-         Mimas_Window* const dummy_window = create_native_window((Mimas_Window_Create_Info){.width = 1280, .height = 720, .title = "MIMAS_HELPER_WINDOW", .decorated = mimas_false});
+    if(backend == MIMAS_BACKEND_GL) {
+        Mimas_Window* const dummy_window = create_dummy_window();
         if(!dummy_window) {
+            DestroyWindow(platform->helper_window);
+            mimas_win_terminate_dpi(platform);
             unregister_window_class();
-            free(platform);
+            _mimas->platform = NULL;
+            CloseHandle(platform->event);
+            _mimas_free(platform);
             // TODO: Error
             return mimas_false;
         }
 
-        HWND const dummy_hwnd = ((Mimas_Win_Window*)dummy_window->native_window)->handle;
-        // If the program is launched with STARTUPINFO, the first call to ShowWindow will ignore the nCmdShow param,
-        //   therefore we call it here to clear that behaviour...
-        ShowWindow(dummy_hwnd, SW_HIDE);
-        // ... and call it again to make sure it's hidden.
-        ShowWindow(dummy_hwnd, SW_HIDE);
-
-        MSG msg;
-        while (PeekMessageW(&msg, dummy_hwnd, 0, 0, PM_REMOVE)) {
-            TranslateMessage(&msg);
-            DispatchMessageW(&msg);
-        }
-
         platform->dummy_window = dummy_window;
-        if(!mimas_platform_init_gl_backend()) {
+        if(!mimas_win_init_gl_backend()) {
             destroy_native_window(dummy_window);
+            DestroyWindow(platform->helper_window);
+            mimas_win_terminate_dpi(platform);
             unregister_window_class();
-            free(platform);
+            _mimas->platform = NULL;
+            CloseHandle(platform->event);
+            _mimas_free(platform);
+            return mimas_false;
+        }
+
+        // Loading WGL needs a window with a pixel format, which only the legacy path could choose. Windows created from now on
+        //   get their format from wglChoosePixelFormatARB, which may pick a different one, and a context can only be made current
+        //   with windows of the format it was created for. Replace the dummy window with one of the default format.
+        Mimas_Window* const context_window = create_dummy_window();
+        destroy_native_window(dummy_window);
+        platform->dummy_window = context_window;
+        if(!context_window) {
+            mimas_win_terminate_gl_backend();
+            DestroyWindow(platform->helper_window);
+            mimas_win_terminate_dpi(platform);
+            unregister_window_class();
+            _mimas->platform = NULL;
+            CloseHandle(platform->event);
+            _mimas_free(platform);
+            // TODO: Error
             return mimas_false;
         }
     } else {
-        if(!mimas_platform_init_vk_backend()) {
+        if(!mimas_win_init_vk_backend()) {
+            DestroyWindow(platform->helper_window);
+            mimas_win_terminate_dpi(platform);
             unregister_window_class();
-            free(platform);
+            _mimas->platform = NULL;
+            CloseHandle(platform->event);
+            _mimas_free(platform);
             return mimas_false;
         }
     }
 
-    _mimas->platform = platform;
-
     return mimas_true;
 }
 
-void mimas_platform_terminate(Mimas_Backend const backend) {
+void mimas_win_platform_terminate(Mimas_Backend const backend) {
     if(backend == MIMAS_BACKEND_GL) {
-        mimas_platform_terminate_gl_backend();
+        mimas_win_terminate_gl_backend();
     } else {
-        mimas_platform_terminate_vk_backend();
+        mimas_win_terminate_vk_backend();
     }
 
     Mimas_Internal* const _mimas = _mimas_get_mimas_internal();
     Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas->platform;
-    destroy_native_window(platform->dummy_window);
+    if(platform->dummy_window) {
+        destroy_native_window(platform->dummy_window);
+    }
+    mimas_win_platform_set_window_pool_size(0);
+    _mimas_free(platform->window_pool.windows);
+    mimas_win_platform_set_gamepad_input_enabled(mimas_false);
+    // Renders any delayed clipboard formats through WM_RENDERALLFORMATS so that the clipboard outlives us.
+    DestroyWindow(platform->helper_window);
+    mimas_win_release_clipboard();
+    mimas_win_terminate_monitors(platform);
+    mimas_win_terminate_dpi(platform);
     unregister_window_class();
-    free(platform);
+    if(platform->wait_timer) {
+        CloseHandle(platform->wait_timer);
+    }
+    CloseHandle(platform->event);
+    _mimas_free(platform);
     _mimas->platform = NULL;
 }
 
-void mimas_platform_poll_events() {
+// TranslateMessage posts WM_CHAR for keystrokes. We skip it for windows that do not want text so that no messages are generated for them.
+// System keystrokes are always translated, otherwise the WM_SYSCHAR that opens the system menu with Alt+Space would be lost.
+static mimas_bool wants_text_input(MSG const* const msg) {
+    if(msg->message != WM_KEYDOWN) {
+        return mimas_true;
+    }
+
+    Mimas_Window const* const window = GetPropW(msg->hwnd, L"Mimas_Window");
+    return !window || (window->event_mask & MIMAS_EVENT_MASK_TEXT);
+}
+
+mimas_u32 mimas_win_platform_poll_events() {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    // Reset before draining so that wakeups posted while we dispatch are not lost.
+    ResetEvent(platform->event);
+    mimas_u32 events = 0;
     MSG msg;
     while(PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
-        TranslateMessage(&msg);
+        if(wants_text_input(&msg)) {
+            TranslateMessage(&msg);
+        }
         DispatchMessage(&msg);
+        events += 1;
     }
 
-    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    // Cloaking does not send any message, so we check shown windows whose visibility somebody cares about on every poll.
+    for(Mimas_Window* window = _mimas_get_mimas_internal()->windows; window; window = window->next) {
+        Mimas_Window_Visibility const state = (Mimas_Window_Visibility)_mimas_atomic_load_i32(&window->visibility.state);
+        mimas_bool const interested = window->callbacks.visibility || _mimas_atomic_load_i32(&window->visibility.throttle_interval_ms) != 0;
+        if(interested && (state == MIMAS_WINDOW_VISIBLE || state == MIMAS_WINDOW_OCCLUDED)) {
+            update_window_visibility(window);
+        }
+    }
+
+    // Refill gradually so that a single poll never stalls on creating many windows.
+    fill_window_pool(&platform->window_pool, 1);
     GetKeyboardState(platform->keyboard_state);
     platform->mouse_state[MIMAS_MOUSE_BUTTON_LEFT] = GetKeyState(VK_LBUTTON) & 0x8000;
     platform->mouse_state[MIMAS_MOUSE_BUTTON_RIGHT] = GetKeyState(VK_RBUTTON) & 0x8000;
     platform->mouse_state[MIMAS_MOUSE_BUTTON_MIDDLE] = GetKeyState(VK_MBUTTON) & 0x8000;
+    return events;
 }
 
-Mimas_Window* mimas_platform_create_window(Mimas_Window_Create_Info const info) {
-    return create_native_window(info);
+Mimas_Window* mimas_win_platform_create_window(Mimas_Window_Create_Info const info) {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    Mimas_Win_Window_Pool* const pool = &platform->window_pool;
+    // Pooled windows already have the default pixel format, which cannot be changed once set.
+    if(pool->count == 0 || info.framebuffer_config) {
+        return create_native_window(info);
+    }
+
+    pool->count -= 1;
+    Mimas_Window* const window = pool->windows[pool->count];
+    Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+    set_window_title(native_window->handle, info.title);
+    UINT flags = SWP_NOMOVE | SWP_NOOWNERZORDER | SWP_NOZORDER | SWP_NOACTIVATE;
+    if(window->decorated != info.decorated) {
+        set_window_decorated(window, info.decorated);
+        flags |= SWP_FRAMECHANGED;
+    }
+    SetWindowPos(native_window->handle, NULL, 0, 0, info.width, info.height, flags);
+    return window;
 }
 
-void mimas_platform_destroy_window(Mimas_Window* const window) {
-    destroy_native_window(window);
+void mimas_win_platform_wait_events(mimas_u32 const timeout_ms) {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    if(timeout_ms != MIMAS_WAIT_FOREVER && timeout_ms > 0 && !platform->wait_timer_created) {
+        platform->wait_timer = mimas_win_create_high_resolution_timer();
+        platform->wait_timer_created = mimas_true;
+    }
+
+    // The timeout of the wait is rounded up to the system timer resolution, which would make redraws scheduled by
+    // mimas_request_redraw miss their refresh. Without a high resolution timer we fall back to the coarse timeout.
+    // MWMO_INPUTAVAILABLE also returns for messages that are already queued but have not been seen by PeekMessage yet.
+    if(timeout_ms != MIMAS_WAIT_FOREVER && timeout_ms > 0 && platform->wait_timer && mimas_win_set_timer(platform->wait_timer, (mimas_u64)timeout_ms * 1000000ULL)) {
+        HANDLE const handles[2] = {platform->event, platform->wait_timer};
+        MsgWaitForMultipleObjectsEx(2, handles, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+        CancelWaitableTimer(platform->wait_timer);
+    } else {
+        MsgWaitForMultipleObjectsEx(1, &platform->event, timeout_ms == MIMAS_WAIT_FOREVER ? INFINITE : timeout_ms, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+    }
 }
 
-void mimas_platform_set_window_pos(Mimas_Window* const window, mimas_i32 const x, mimas_i32 const y) {
-    Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
-    SetWindowPos(native_window->handle, NULL, x, y, 0, 0, SWP_NOSIZE | SWP_NOOWNERZORDER | SWP_NOZORDER | SWP_NOACTIVATE);
+void mimas_win_platform_post_empty_event() {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    SetEvent(platform->event);
 }
 
-void mimas_platform_get_window_pos(Mimas_Window*const window, mimas_i32* const x, mimas_i32* const y) {
-    Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
-    RECT window_rect;
-    GetWindowRect(native_window->handle, &window_rect);
-    *x = window_rect.left;
-    *y = window_rect.top;
+void* mimas_win_platform_get_event_handle() {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    return platform->event;
 }
 
-void mimas_platform_set_window_content_pos(Mimas_Window* const window, mimas_i32 const x, mimas_i32 const y) {
-    Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
-    if(window->decorated) {
-        RECT pos = {x, y, x, y};
-        // TODO: Make DPI aware.
-        AdjustWindowRectEx(&pos, get_window_styles(window), FALSE, get_window_extended_styles(window));
-        SetWindowPos(native_window->handle, NULL, pos.left, pos.top, 0, 0, SWP_NOSIZE | SWP_NOOWNERZORDER | SWP_NOZORDER | SWP_NOACTIVATE);
-    } else {
-        SetWindowPos(native_window->handle, NULL, x, y, 0, 0, SWP_NOSIZE | SWP_NOOWNERZORDER | SWP_NOZORDER | SWP_NOACTIVATE);
+void mimas_win_platform_set_window_pool_size(mimas_u32 const size) {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    Mimas_Win_Window_Pool* const pool = &platform->window_pool;
+    while(pool->count > size) {
+        pool->count -= 1;
+        destroy_native_window(pool->windows[pool->count]);
+    }
+
+    if(size == 0) {
+        _mimas_free(pool->windows);
+        pool->windows = NULL;
+        pool->size = 0;
+        return;
     }
+
+    Mimas_Window** const windows = (Mimas_Window**)_mimas_realloc(pool->windows, sizeof(Mimas_Window*) * size);
+    if(!windows) {
+        // The old array stays in place and its capacity is the previous size, so the pool is refilled to at most that.
+        pool->size = pool->size < size ? pool->size : size;
+        // TODO: Error
+        return;
+    }
+
+    pool->windows = windows;
+    pool->size = size;
+    fill_window_pool(pool, size);
 }
 
-void mimas_platform_get_window_content_pos(Mimas_Window*const window, mimas_i32* const x, mimas_i32* const y) {
-    Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
-    POINT pos = {0, 0};
-    ClientToScreen(native_window->handle, &pos);
-    *x = pos.x;
-    *y = pos.y;
+void mimas_win_platform_destroy_window(Mimas_Window* const window) {
+    destroy_native_window(window);
 }
 
-void mimas_platform_set_window_content_size(Mimas_Window*const window, mimas_i32 const width, mimas_i32 const height) {
+void mimas_win_platform_get_window_pos(Mimas_Window*const window, mimas_i32* const x, mimas_i32* const y) {
     Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
-    if(window->decorated) {
-        RECT rect = {0, 0, width, height};
-        // TODO: Make DPI aware.
-        AdjustWindowRectEx(&rect, get_window_styles(window), FALSE, get_window_extended_styles(window));
-        SetWindowPos(native_window->handle, NULL, 0, 0, rect.right - rect.left, rect.bottom - rect.top, SWP_NOMOVE | SWP_NOOWNERZORDER | SWP_NOZORDER | SWP_NOACTIVATE);
-    } else {
-        SetWindowPos(native_window->handle, NULL, 0, 0, width, height, SWP_NOMOVE | SWP_NOOWNERZORDER | SWP_NOZORDER | SWP_NOACTIVATE);
-    }
+    *x = native_window->window_rect.left;
+    *y = native_window->window_rect.top;
 }
 
-void mimas_platform_get_window_content_size(Mimas_Window*const window, mimas_i32* const width, mimas_i32* const height) {
+void mimas_win_platform_get_window_content_pos(Mimas_Window*const window, mimas_i32* const x, mimas_i32* const y) {
     Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
-    RECT client_rect;
-    GetClientRect(native_window->handle, &client_rect);
-    *width = client_rect.right;
-    *height = client_rect.bottom;
+    *x = native_window->client_rect.left;
+    *y = native_window->client_rect.top;
 }
 
-void mimas_platform_show_window(Mimas_Window* const window) {
+typedef struct {
+    HWND handle;
+    mimas_i32 x;
+    mimas_i32 y;
+    mimas_i32 width;
+    mimas_i32 height;
+    UINT flags;
+} Mimas_Win_Window_Pos;
+
+// Applies the parts of the update that cannot be batched and translates the rest into SetWindowPos arguments.
+// Returns mimas_false if the window does not need to be repositioned.
+static mimas_bool prepare_window_update(Mimas_Window* const window, Mimas_Win_Window_Pos* const pos) {
     Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
-    ShowWindow(native_window->handle, SW_SHOW);
+    mimas_u32 const update = window->update.flags;
+    UINT flags = SWP_NOMOVE | SWP_NOSIZE | SWP_NOOWNERZORDER | SWP_NOZORDER | SWP_NOACTIVATE;
+
+    if(update & MIMAS_WINDOW_UPDATE_TITLE) {
+        set_window_title(native_window->handle, window->update.title);
+    }
+
+    if((update & MIMAS_WINDOW_UPDATE_DECORATED) && window->decorated != window->update.decorated) {
+        set_window_decorated(window, window->update.decorated);
+        flags |= SWP_FRAMECHANGED;
+    }
+
+    RECT rect = native_window->window_rect;
+    if(update & (MIMAS_WINDOW_UPDATE_CONTENT_POS | MIMAS_WINDOW_UPDATE_CONTENT_SIZE)) {
+        RECT content = native_window->client_rect;
+        if(update & MIMAS_WINDOW_UPDATE_CONTENT_POS) {
+            OffsetRect(&content, window->update.x - content.left, window->update.y - content.top);
+        }
+        if(update & MIMAS_WINDOW_UPDATE_CONTENT_SIZE) {
+            content.right = content.left + logical_to_pixels(window, window->update.width);
+            content.bottom = content.top + logical_to_pixels(window, window->update.height);
+        }
+
+        // Uses the decoration state after the update so that both change in the same reconfiguration.
+        if(window->decorated) {
+            mimas_win_adjust_window_rect(&content, get_window_styles(window), get_window_extended_styles(window), mimas_win_get_window_dpi(native_window->handle));
+        }
+
+        if(update & MIMAS_WINDOW_UPDATE_CONTENT_POS) {
+            rect.left = content.left;
+            rect.top = content.top;
+            flags &= ~SWP_NOMOVE;
+        }
+        if(update & MIMAS_WINDOW_UPDATE_CONTENT_SIZE) {
+            rect.right = rect.left + (content.right - content.left);
+            rect.bottom = rect.top + (content.bottom - content.top);
+            flags &= ~SWP_NOSIZE;
+        }
+    }
+
+    if(update & MIMAS_WINDOW_UPDATE_POS) {
+        OffsetRect(&rect, window->update.x - rect.left, window->update.y - rect.top);
+        flags &= ~SWP_NOMOVE;
+    }
+
+    if(update & MIMAS_WINDOW_UPDATE_VISIBLE) {
+        if(window->update.visible) {
+            // Showing activates the window like ShowWindow(SW_SHOW) does.
+            flags = (flags & ~SWP_NOACTIVATE) | SWP_SHOWWINDOW;
+        } else {
+            flags |= SWP_HIDEWINDOW;
+        }
+    }
+
+    *pos = (Mimas_Win_Window_Pos){
+        .handle = native_window->handle,
+        .x = rect.left,
+        .y = rect.top,
+        .width = rect.right - rect.left,
+        .height = rect.bottom - rect.top,
+        .flags = flags,
+    };
+    UINT const no_change = SWP_NOMOVE | SWP_NOSIZE;
+    return (flags & no_change) != no_change || (flags & (SWP_FRAMECHANGED | SWP_SHOWWINDOW | SWP_HIDEWINDOW));
 }
 
-void mimas_platform_hide_window(Mimas_Window* const window) {
+void mimas_win_platform_apply_window_updates(Mimas_Window* const* const windows, mimas_u32 const count) {
+    Mimas_Win_Window_Pos* const positions = (Mimas_Win_Window_Pos*)_mimas_malloc(sizeof(Mimas_Win_Window_Pos) * count);
+    if(!positions) {
+        // Without room to defer the positions we apply them one by one.
+        for(mimas_u32 i = 0; i < count; ++i) {
+            Mimas_Win_Window_Pos pos;
+            if(windows[i]->update.flags && prepare_window_update(windows[i], &pos)) {
+                SetWindowPos(pos.handle, NULL, pos.x, pos.y, pos.width, pos.height, pos.flags);
+            }
+        }
+        return;
+    }
+
+    mimas_u32 position_count = 0;
+    for(mimas_u32 i = 0; i < count; ++i) {
+        if(windows[i]->update.flags && prepare_window_update(windows[i], &positions[position_count])) {
+            position_count += 1;
+        }
+    }
+
+    // DeferWindowPos lets the system reposition all windows in a single screen update.
+    HDWP hdwp = position_count > 1 ? BeginDeferWindowPos(position_count) : NULL;
+    for(mimas_u32 i = 0; hdwp && i < position_count; ++i) {
+        Mimas_Win_Window_Pos const* const pos = &positions[i];
+        hdwp = DeferWindowPos(hdwp, pos->handle, NULL, pos->x, pos->y, pos->width, pos->height, pos->flags);
+    }
+
+    // DeferWindowPos discards all positions on failure, in which case we fall back to positioning the windows one by one.
+    if(!hdwp || !EndDeferWindowPos(hdwp)) {
+        for(mimas_u32 i = 0; i < position_count; ++i) {
+            Mimas_Win_Window_Pos const* const pos = &positions[i];
+            SetWindowPos(pos->handle, NULL, pos->x, pos->y, pos->width, pos->height, pos->flags);
+        }
+    }
+
+    _mimas_free(positions);
+}
+
+void mimas_win_platform_get_window_content_size(Mimas_Window*const window, mimas_i32* const width, mimas_i32* const height) {
+    mimas_i32 framebuffer_width;
+    mimas_i32 framebuffer_height;
+    mimas_win_platform_get_window_framebuffer_size(window, &framebuffer_width, &framebuffer_height);
+    *width = pixels_to_logical(window, framebuffer_width);
+    *height = pixels_to_logical(window, framebuffer_height);
+}
+
+void mimas_win_platform_get_window_framebuffer_size(Mimas_Window* const window, mimas_i32* const width, mimas_i32* const height) {
+    // The process is DPI aware, therefore the client area is not scaled and maps 1:1 to framebuffer pixels.
     Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
-    ShowWindow(native_window->handle, SW_HIDE);
+    *width = native_window->client_rect.right - native_window->client_rect.left;
+    *height = native_window->client_rect.bottom - native_window->client_rect.top;
 }
 
-void mimas_platform_restore_window(Mimas_Window* const window) {
+void mimas_win_platform_restore_window(Mimas_Window* const window) {
     Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
     ShowWindow(native_window->handle, SW_RESTORE);
 }
 
-void mimas_platform_minimize_window(Mimas_Window* const window) {
+void mimas_win_platform_minimize_window(Mimas_Window* const window) {
     Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
     ShowWindow(native_window->handle, SW_MINIMIZE);
 }
 
-void mimas_platform_maximize_window(Mimas_Window* const window) {
+void mimas_win_platform_maximize_window(Mimas_Window* const window) {
     Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
     ShowWindow(native_window->handle, SW_MAXIMIZE);
 }
 
+mimas_bool mimas_win_platform_set_window_fullscreen(Mimas_Window* const window, Mimas_Fullscreen_Mode const mode, mimas_u32 const monitor_index, Mimas_Video_Mode const* const video_mode) {
+    Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+    HWND const hwnd = native_window->handle;
+    DWORD const visible = GetWindowLongW(hwnd, GWL_STYLE) & WS_VISIBLE;
+    if(mode == MIMAS_WINDOWED) {
+        if(window->fullscreen == MIMAS_WINDOWED) {
+            return mimas_true;
+        }
+
+        reset_display_mode(native_window);
+        memset(&native_window->display_mode, 0, sizeof(DEVMODEW));
+        window->fullscreen = MIMAS_WINDOWED;
+        SetWindowLongW(hwnd, GWL_STYLE, (native_window->windowed_style & ~WS_VISIBLE) | visible);
+        set_window_decorated(window, window->decorated);
+        WINDOWPLACEMENT placement = native_window->windowed_placement;
+        if(!visible) {
+            placement.showCmd = SW_HIDE;
+        }
+        SetWindowPlacement(hwnd, &placement);
+        SetWindowPos(hwnd, NULL, 0, 0, 0, 0, SWP_FRAMECHANGED | SWP_NOSIZE | SWP_NOMOVE | SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOACTIVATE);
+        return mimas_true;
+    }
+
+    HMONITOR const monitor = mimas_win_get_monitor_handle(monitor_index);
+    MONITORINFOEXW info = {.cbSize = sizeof(MONITORINFOEXW)};
+    if(!monitor || !GetMonitorInfoW(monitor, (MONITORINFO*)&info)) {
+        // TODO: Error
+        return mimas_false;
+    }
+
+    if(mode == MIMAS_FULLSCREEN_EXCLUSIVE && video_mode) {
+        DEVMODEW display_mode = {.dmSize = sizeof(DEVMODEW)};
+        display_mode.dmFields = DM_PELSWIDTH | DM_PELSHEIGHT;
+        display_mode.dmPelsWidth = video_mode->width;
+        display_mode.dmPelsHeight = video_mode->height;
+        if(video_mode->refresh_rate != 0) {
+            display_mode.dmFields |= DM_DISPLAYFREQUENCY;
+            display_mode.dmDisplayFrequency = video_mode->refresh_rate;
+        }
+
+        // Set the new mode before we give up the old one so that a failure leaves the window as it was.
+        if(ChangeDisplaySettingsExW(info.szDevice, &display_mode, NULL, CDS_FULLSCREEN, NULL) != DISP_CHANGE_SUCCESSFUL) {
+            // TODO: Error
+            return mimas_false;
+        }
+
+        if(lstrcmpW(native_window->display_device, info.szDevice) != 0) {
+            reset_display_mode(native_window);
+        }
+        memcpy(native_window->display_device, info.szDevice, sizeof(native_window->display_device));
+        native_window->display_mode = display_mode;
+        native_window->display_mode_set = mimas_true;
+        mimas_win_invalidate_monitors();
+    } else {
+        reset_display_mode(native_window);
+        memset(&native_window->display_mode, 0, sizeof(DEVMODEW));
+    }
+
+    if(window->fullscreen == MIMAS_WINDOWED) {
+        native_window->windowed_style = GetWindowLongW(hwnd, GWL_STYLE);
+        native_window->windowed_placement.length = sizeof(WINDOWPLACEMENT);
+        GetWindowPlacement(hwnd, &native_window->windowed_placement);
+    }
+
+    window->fullscreen = mode;
+    native_window->fullscreen_monitor = monitor;
+    // Without a frame or non-client area the swap chain covers the monitor exactly,
+    // which lets DWM present a flip model swap chain directly instead of composing it.
+    MARGINS const margins = {0, 0, 0, 0};
+    DwmExtendFrameIntoClientArea(hwnd, &margins);
+    SetWindowLongW(hwnd, GWL_STYLE, WS_CLIPSIBLINGS | WS_CLIPCHILDREN | WS_POPUP | visible);
+    cover_fullscreen_monitor(native_window);
+    return mimas_true;
+}
+
+void mimas_win_platform_inject_key(Mimas_Window* const window, Mimas_Key const key, Mimas_Key_Action const action, mimas_u64 const timestamp_ns) {
+    Mimas_Win_Platform* const platform = (Mimas_Win_Platform*)_mimas_get_mimas_internal()->platform;
+    Mimas_Win_Window* const native_window = (Mimas_Win_Window*)window->native_window;
+    // Some keys only differ from others by the extended flag, e.g. the numpad enter key from the main one.
+    mimas_u32 vk = 0;
+    mimas_bool extended = mimas_false;
+    while(vk < ARRAY_SIZE(platform->keys) && translate_key(vk, mimas_false) != key) {
+        if(translate_key(vk, mimas_true) == key) {
+            extended = mimas_true;
+            break;
+        }
+        vk += 1;
+    }
+
+    if(vk == ARRAY_SIZE(platform->keys)) {
+        // TODO: Error
+        return;
+    }
+
+    // Repeat count 1, bit 30 the previous state of the key and bit 31 set for releases, as for keyboard messages from the system.
+    LPARAM lparam = 1 | MIMAS_WIN_INJECTED_KEY;
+    if(action != MIMAS_KEY_PRESS) {
+        lparam |= 0x40000000;
+    }
+    if(action == MIMAS_KEY_RELEASE) {
+        lparam |= 0x80000000;
+    }
+    if(extended) {
+        lparam |= (LPARAM)KF_EXTENDED << 16;
+    }
+
+    // Keys posted before an earlier one has been delivered are covered by the measurement of the earlier key.
+    _mimas_atomic_cas_u64(&native_window->injected_key_ns, 0, timestamp_ns);
+    // Posting to the window's queue instead of SendInput keeps the event independent of focus and of other applications.
+    PostMessageW(native_window->handle, action == MIMAS_KEY_RELEASE ? WM_KEYUP : WM_KEYDOWN, vk, lparam);
+}
+
 // TODO: Move to input.c
-void mimas_platform_set_cursor_mode(Mimas_Window* const window, Mimas_Cursor_Mode const cursor_mode) {
+void mimas_win_platform_set_cursor_mode(Mimas_Window* const window, Mimas_Cursor_Mode const cursor_mode) {
     window->cursor_mode = cursor_mode;
 }
+
+#define _MIMAS_WIN_PLATFORM_VTABLE_ENTRY(return_type, function, parameters) .function = mimas_win_platform_##function,
+
+Mimas_Platform_Vtable const mimas_win_platform_vtable = {
+    .name = "win32",
+    MIMAS_PLATFORM_FUNCTIONS(_MIMAS_WIN_PLATFORM_VTABLE_ENTRY)
+};
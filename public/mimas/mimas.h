@@ -151,18 +151,88 @@ typedef struct Mimas_Rect {
 
 typedef struct Mimas_Window Mimas_Window;
 
+/*
+ * Sets the comma-separated list of platform backends that mimas_init_with_gl and mimas_init_with_vk try in order,
+ * e.g. "win32,headless". The MIMAS_PLATFORM environment variable takes precedence over the hint.
+ * Without either, every compiled-in backend except headless is tried. Pass NULL to clear the hint.
+ * Has no effect in builds with a single backend.
+ */
+MIMAS_API void mimas_set_platform_hint(char const* platforms);
+/*
+ * Returns: The name of the backend mimas has been initialized with or NULL if mimas is not initialized.
+ */
+MIMAS_API char const* mimas_get_platform_name();
+
 MIMAS_API void mimas_terminate();
 
 MIMAS_API void mimas_poll_events();
 
+/*
+ * Dispatches the events that are ready without blocking. Same as mimas_poll_events.
+ * Returns: The number of native events that have been dispatched.
+ */
+MIMAS_API mimas_u32 mimas_dispatch_pending();
+
+#define MIMAS_WAIT_FOREVER 0xFFFFFFFF
+
+/*
+ * Blocks until events are available or timeout_ms milliseconds have elapsed and dispatches them.
+ * Pass MIMAS_WAIT_FOREVER to wait without a timeout.
+ */
+MIMAS_API void mimas_wait_events(mimas_u32 timeout_ms);
+
+/*
+ * Wakes up mimas_wait_events and signals the event handle. May be called from any thread.
+ */
+MIMAS_API void mimas_post_empty_event();
+
+/*
+ * Returns a handle that is signaled when mimas has work that does not arrive through the message queue of the thread,
+ * e.g. gamepad input or mimas_post_empty_event. The handle stays signaled until the events are dispatched.
+ * To integrate mimas into an external event loop, wait on the handle together with the message queue of the thread
+ * that initialized mimas (MsgWaitForMultipleObjectsEx with QS_ALLINPUT) and call mimas_dispatch_pending when either is ready.
+ * Returns: A HANDLE on Windows.
+ */
+MIMAS_API void* mimas_get_event_handle();
+
+typedef struct Mimas_Framebuffer_Config {
+    mimas_i32 red_bits;
+    mimas_i32 green_bits;
+    mimas_i32 blue_bits;
+    mimas_i32 alpha_bits;
+    // 0 omits the buffer. Windows that render through offscreen targets usually need neither.
+    mimas_i32 depth_bits;
+    mimas_i32 stencil_bits;
+    // Number of MSAA samples. 0 disables multisampling.
+    mimas_i32 samples;
+    mimas_bool srgb;
+    // 1 for single buffering, 2 for double buffering. Windows does not support more than 2.
+    mimas_i32 buffer_count;
+} Mimas_Framebuffer_Config;
+
 typedef struct Mimas_Window_Create_Info {
     mimas_i32 width;
     mimas_i32 height;
     char const* title;
     mimas_bool decorated;
+    // Framebuffer of the window when mimas has been initialized with GL. Ignored by Vulkan.
+    // NULL selects RGBA8 with 24 depth bits, 8 stencil bits and double buffering.
+    Mimas_Framebuffer_Config const* framebuffer_config;
 } Mimas_Window_Create_Info;
 
 MIMAS_API Mimas_Window* mimas_create_window(Mimas_Window_Create_Info);
+/*
+ * Creates count windows and writes them to windows.
+ * Returns: mimas_true if all windows have been created. On failure no windows are created.
+ */
+MIMAS_API mimas_bool mimas_create_windows(Mimas_Window_Create_Info const* infos, mimas_u32 count, Mimas_Window** windows);
+/*
+ * Keeps size hidden windows created in advance, which mimas_create_window hands out instead of creating new ones.
+ * The pool is filled immediately and afterwards refilled by mimas_poll_events, one window per call.
+ * The default size is 0, which disables the pool.
+ */
+MIMAS_API void mimas_set_window_pool_size(mimas_u32 size);
+// May be called from callbacks. The window stops receiving callbacks immediately and is freed when the dispatch returns.
 MIMAS_API void mimas_destroy_window(Mimas_Window* window);
 MIMAS_API mimas_bool mimas_close_requested(Mimas_Window* window);
 
@@ -193,6 +263,64 @@ typedef void (*mimas_window_key_callback)(Mimas_Window* window, Mimas_Key key, M
 MIMAS_API void mimas_set_window_key_callback(Mimas_Window* window, mimas_window_key_callback callback, void* user_data);
 MIMAS_API Mimas_Callback mimas_get_window_key_callback(Mimas_Window* window);
 
+/*
+ * text is the UTF-8 encoded text input that the window has received since the last call to mimas_poll_events.
+ * text is not null-terminated. The callback is invoked at most once per window per mimas_poll_events.
+ * Control characters are not reported as text input.
+ */
+typedef void (*mimas_window_text_callback)(Mimas_Window* window, char const* text, mimas_u32 length, void* user_data);
+MIMAS_API void mimas_set_window_text_callback(Mimas_Window* window, mimas_window_text_callback callback, void* user_data);
+MIMAS_API Mimas_Callback mimas_get_window_text_callback(Mimas_Window* window);
+
+/*
+ * width and height are the size of the content area in logical units, i.e. pixels divided by the content scale.
+ * framebuffer_width and framebuffer_height are the size of the window's framebuffer in pixels.
+ * Size changes are coalesced and the latest size is reported at most once per window per mimas_poll_events.
+ * While the user resizes the window interactively, the callback is additionally invoked from within the resize loop
+ * at most once per resize interval (see mimas_set_window_resize_interval). The final size is always reported.
+ */
+typedef void (*mimas_window_resize_callback)(Mimas_Window* window, mimas_i32 width, mimas_i32 height, mimas_i32 framebuffer_width, mimas_i32 framebuffer_height, void* user_data);
+MIMAS_API void mimas_set_window_resize_callback(Mimas_Window* window, mimas_window_resize_callback callback, void* user_data);
+MIMAS_API Mimas_Callback mimas_get_window_resize_callback(Mimas_Window* window);
+
+/*
+ * Limits how often the resize callback is invoked during interactive resizing.
+ * 0 (the default) reports every size change.
+ */
+MIMAS_API void mimas_set_window_resize_interval(Mimas_Window* window, mimas_u32 milliseconds);
+
+typedef enum Mimas_Event_Mask {
+    MIMAS_EVENT_MASK_ACTIVATE = 1 << 0,
+    MIMAS_EVENT_MASK_CURSOR_POS = 1 << 1,
+    MIMAS_EVENT_MASK_MOUSE_BUTTON = 1 << 2,
+    MIMAS_EVENT_MASK_KEY = 1 << 3,
+    MIMAS_EVENT_MASK_TEXT = 1 << 4,
+    MIMAS_EVENT_MASK_RESIZE = 1 << 5,
+    MIMAS_EVENT_MASK_CONTENT_SCALE = 1 << 6,
+    MIMAS_EVENT_MASK_VISIBILITY = 1 << 7,
+    MIMAS_EVENT_MASK_REDRAW = 1 << 8,
+    MIMAS_EVENT_MASK_ALL = (1 << 9) - 1,
+} Mimas_Event_Mask;
+
+/*
+ * Selects the classes of input and window events the window processes. Windows start with MIMAS_EVENT_MASK_ALL.
+ * Masked events are dropped as early as the platform allows and their callbacks are not invoked.
+ * The state that masked events would update, e.g. the keys returned by mimas_get_key, is not updated either.
+ * On Windows, masking MIMAS_EVENT_MASK_TEXT also stops keystrokes from being translated to character messages.
+ * Alt keystrokes are still translated because the system menu and menu mnemonics depend on them.
+ * The hittest callback cannot be masked. Moving and resizing the window depend on it.
+ */
+MIMAS_API void mimas_set_window_event_mask(Mimas_Window* window, mimas_u32 mask);
+MIMAS_API mimas_u32 mimas_get_window_event_mask(Mimas_Window* window);
+
+/*
+ * The content scale is the ratio between the window's current DPI and the platform's default DPI.
+ * Divide the framebuffer size by the content scale to get the size in logical units.
+ */
+typedef void (*mimas_window_content_scale_callback)(Mimas_Window* window, float scale_x, float scale_y, void* user_data);
+MIMAS_API void mimas_set_window_content_scale_callback(Mimas_Window* window, mimas_window_content_scale_callback callback, void* user_data);
+MIMAS_API Mimas_Callback mimas_get_window_content_scale_callback(Mimas_Window* window);
+
 /*
  * Set custom hit function for the native window to define custom resize, drag, minimize, maximize and close behaviour.
  */
@@ -204,22 +332,413 @@ MIMAS_API void mimas_set_window_pos(Mimas_Window* window, mimas_i32 x, mimas_i32
 MIMAS_API void mimas_get_window_pos(Mimas_Window* window, mimas_i32* x, mimas_i32* y);
 MIMAS_API void mimas_set_window_content_pos(Mimas_Window* window, mimas_i32 x, mimas_i32 y);
 MIMAS_API void mimas_get_window_content_pos(Mimas_Window* window, mimas_i32* x, mimas_i32* y);
+// Content sizes are in logical units like the sizes passed to the resize callback. Positions are in screen pixels.
+// On Windows mimas makes the process per-monitor DPI aware at init, which switches the units of all Win32 coordinates
+// the host application uses from scaled to physical pixels.
 MIMAS_API void mimas_set_window_content_size(Mimas_Window* window, mimas_i32 width, mimas_i32 height);
 MIMAS_API void mimas_get_window_content_size(Mimas_Window* window, mimas_i32* width, mimas_i32* height);
+MIMAS_API void mimas_get_window_framebuffer_size(Mimas_Window* window, mimas_i32* width, mimas_i32* height);
+MIMAS_API void mimas_get_window_content_scale(Mimas_Window* window, float* scale_x, float* scale_y);
 
 MIMAS_API void mimas_show_window(Mimas_Window* window);
 MIMAS_API void mimas_hide_window(Mimas_Window* window);
+
+typedef enum Mimas_Window_Visibility {
+    // The window has not been shown or has been hidden. Windows start hidden.
+    MIMAS_WINDOW_HIDDEN,
+    MIMAS_WINDOW_VISIBLE,
+    MIMAS_WINDOW_MINIMIZED,
+    // The window is shown but the system does not display it, e.g. because it is on another virtual desktop.
+    MIMAS_WINDOW_OCCLUDED,
+} Mimas_Window_Visibility;
+
+MIMAS_API Mimas_Window_Visibility mimas_get_window_visibility(Mimas_Window* window);
+
+/*
+ * Invoked from mimas_poll_events when the visibility of the window has changed.
+ * Changes are coalesced and only the latest visibility is reported.
+ */
+typedef void (*mimas_window_visibility_callback)(Mimas_Window* window, Mimas_Window_Visibility visibility, void* user_data);
+MIMAS_API void mimas_set_window_visibility_callback(Mimas_Window* window, mimas_window_visibility_callback callback, void* user_data);
+MIMAS_API Mimas_Callback mimas_get_window_visibility_callback(Mimas_Window* window);
+
+/*
+ * While the window is not MIMAS_WINDOW_VISIBLE, mimas_swap_buffers sleeps for interval_ms milliseconds
+ * instead of presenting, which limits a render loop that does not check the visibility to 1000 / interval_ms frames per second.
+ * 0 (the default) disables throttling.
+ */
+MIMAS_API void mimas_set_window_auto_throttle(Mimas_Window* window, mimas_u32 interval_ms);
+
+/*
+ * Invoked from mimas_poll_events after mimas_request_redraw has been called for the window.
+ * The window should render and present exactly one frame.
+ */
+typedef void (*mimas_window_redraw_callback)(Mimas_Window* window, void* user_data);
+MIMAS_API void mimas_set_window_redraw_callback(Mimas_Window* window, mimas_window_redraw_callback callback, void* user_data);
+MIMAS_API Mimas_Callback mimas_get_window_redraw_callback(Mimas_Window* window);
+
+/*
+ * Requests an invocation of the redraw callback of window. May be called from any thread.
+ * All requests made before the callback starts are served by a single invocation and the callback is invoked
+ * at most once per refresh of the display, at the start of a refresh interval if the platform reports vertical blanks.
+ * mimas_wait_events returns early for a pending request. Requests are held while the window is hidden or minimized.
+ */
+MIMAS_API void mimas_request_redraw(Mimas_Window* window);
+
+MIMAS_API void mimas_set_window_title(Mimas_Window* window, char const* title);
+MIMAS_API void mimas_set_window_decorated(Mimas_Window* window, mimas_bool decorated);
+
+/*
+ * Starts a transaction on window. Until mimas_commit_window_update is called, mimas_set_window_pos,
+ * mimas_set_window_content_pos, mimas_set_window_content_size, mimas_show_window, mimas_hide_window,
+ * mimas_set_window_title and mimas_set_window_decorated only record the change.
+ * Getters keep returning the committed state.
+ */
+MIMAS_API void mimas_begin_window_update(Mimas_Window* window);
+/*
+ * Applies all changes recorded since mimas_begin_window_update with a single native reconfiguration.
+ */
+MIMAS_API void mimas_commit_window_update(Mimas_Window* window);
+/*
+ * Commits the transactions of multiple windows at once so that all of the changes appear in the same frame.
+ */
+MIMAS_API void mimas_commit_window_updates(Mimas_Window* const* windows, mimas_u32 count);
 MIMAS_API void mimas_restore_window(Mimas_Window* window);
 MIMAS_API void mimas_minimize_window(Mimas_Window* window);
 MIMAS_API void mimas_maximize_window(Mimas_Window* window);
 
 MIMAS_API void mimas_set_cursor_mode(Mimas_Window* window, Mimas_Cursor_Mode);
+// Returns the cursor position in screen coordinates. While the cursor is over one of our windows,
+// the position is the one reported by the last mimas_poll_events and the query does not call into the system.
 MIMAS_API void mimas_get_cursor_pos(mimas_i32* x, mimas_i32* y);
 
 // Note that this function only ever returns MIMAS_MOUSE_BUTTON_PRESS or MIMAS_MOUSE_BUTTON_RELEASE 
 // to indicate that the mouse button is currently down or not
 MIMAS_API Mimas_Mouse_Button_Action mimas_get_mouse_button(Mimas_Mouse_Button button);
 
+typedef struct Mimas_Monitor {
+    // UTF-8 name of the display device. Stable for as long as the monitor stays connected.
+    char name[128];
+    // Bounds of the monitor and of its work area (the monitor without taskbars and docks) in screen coordinates.
+    Mimas_Rect rect;
+    Mimas_Rect work_rect;
+    float content_scale;
+    // The exact refresh rate is refresh_rate_numerator / refresh_rate_denominator Hz, e.g. 60000 / 1001 for 59.94 Hz.
+    mimas_u32 refresh_rate_numerator;
+    mimas_u32 refresh_rate_denominator;
+    mimas_bool primary;
+} Mimas_Monitor;
+
+/*
+ * Writes at most capacity monitors to monitors. The primary monitor is always first.
+ * Returns: The number of connected monitors.
+ */
+MIMAS_API mimas_u32 mimas_get_monitors(Mimas_Monitor* monitors, mimas_u32 capacity);
+
+/*
+ * Invoked from mimas_poll_events when a monitor has been connected, disconnected or its configuration has changed.
+ */
+typedef void (*mimas_monitors_changed_callback)(void* user_data);
+MIMAS_API void mimas_set_monitors_changed_callback(mimas_monitors_changed_callback callback, void* user_data);
+MIMAS_API Mimas_Callback mimas_get_monitors_changed_callback();
+
+typedef enum Mimas_Fullscreen_Mode {
+    MIMAS_WINDOWED,
+    // Undecorated window that covers the monitor without changing its video mode.
+    MIMAS_FULLSCREEN_BORDERLESS,
+    // Changes the video mode of the monitor while the window is active. The window is minimized when it loses focus.
+    MIMAS_FULLSCREEN_EXCLUSIVE,
+} Mimas_Fullscreen_Mode;
+
+typedef struct Mimas_Video_Mode {
+    mimas_i32 width;
+    mimas_i32 height;
+    // 0 keeps the current refresh rate.
+    mimas_u32 refresh_rate;
+} Mimas_Video_Mode;
+
+/*
+ * Makes window cover the monitor at monitor_index in the order of mimas_get_monitors or returns it to the position
+ * and decorations it had before it went fullscreen. video_mode is only used by MIMAS_FULLSCREEN_EXCLUSIVE; NULL keeps the current mode.
+ * Fullscreen windows have no frame of their own so that the compositor can present them without a copy,
+ * e.g. through independent flip with a flip model swap chain on Windows.
+ * Returns: mimas_false if there is no such monitor or the video mode could not be set. The window is left unchanged.
+ */
+MIMAS_API mimas_bool mimas_set_window_fullscreen(Mimas_Window* window, Mimas_Fullscreen_Mode mode, mimas_u32 monitor_index, Mimas_Video_Mode const* video_mode);
+MIMAS_API Mimas_Fullscreen_Mode mimas_get_window_fullscreen(Mimas_Window* window);
+
+/*
+ * Screen captures read the contents of a monitor and track which parts of it have changed.
+ * After the first frame only the changed regions are copied into the capture's buffer.
+ */
+typedef struct Mimas_Screen_Capture Mimas_Screen_Capture;
+
+typedef struct Mimas_Screen_Frame {
+    // BGRA8 pixels of the whole monitor with the top row first. The buffer is owned by the capture and
+    // updated in place, so it stays valid until the next mimas_capture_screen or mimas_destroy_screen_capture.
+    void const* pixels;
+    mimas_i32 width;
+    mimas_i32 height;
+    // Size of a row in bytes.
+    mimas_i32 stride;
+    // Regions that have changed since the previous frame in pixels relative to the monitor. The whole monitor for the first frame.
+    Mimas_Rect const* dirty_rects;
+    mimas_u32 dirty_rect_count;
+    mimas_u64 timestamp_ns;
+} Mimas_Screen_Frame;
+
+/*
+ * Starts capturing the monitor at monitor_index in the order of mimas_get_monitors.
+ * Returns: NULL if the monitor does not exist or the platform cannot capture it.
+ */
+MIMAS_API Mimas_Screen_Capture* mimas_create_screen_capture(mimas_u32 monitor_index);
+MIMAS_API void mimas_destroy_screen_capture(Mimas_Screen_Capture* capture);
+/*
+ * Waits up to timeout_ms milliseconds for the contents of the monitor to change and updates frame.
+ * If the capture has been interrupted, e.g. by a mode change or a secure desktop, it is restarted and
+ * the next frame reports the whole monitor as dirty.
+ * Returns: mimas_false if nothing has changed within the timeout.
+ */
+MIMAS_API mimas_bool mimas_capture_screen(Mimas_Screen_Capture* capture, mimas_u32 timeout_ms, Mimas_Screen_Frame* frame);
+
+#define MIMAS_MAX_GAMEPADS 4
+
+typedef enum Mimas_Gamepad_Button {
+    MIMAS_GAMEPAD_BUTTON_A,
+    MIMAS_GAMEPAD_BUTTON_B,
+    MIMAS_GAMEPAD_BUTTON_X,
+    MIMAS_GAMEPAD_BUTTON_Y,
+    MIMAS_GAMEPAD_BUTTON_LEFT_BUMPER,
+    MIMAS_GAMEPAD_BUTTON_RIGHT_BUMPER,
+    MIMAS_GAMEPAD_BUTTON_BACK,
+    MIMAS_GAMEPAD_BUTTON_START,
+    MIMAS_GAMEPAD_BUTTON_LEFT_THUMB,
+    MIMAS_GAMEPAD_BUTTON_RIGHT_THUMB,
+    MIMAS_GAMEPAD_BUTTON_DPAD_UP,
+    MIMAS_GAMEPAD_BUTTON_DPAD_DOWN,
+    MIMAS_GAMEPAD_BUTTON_DPAD_LEFT,
+    MIMAS_GAMEPAD_BUTTON_DPAD_RIGHT,
+    MIMAS_GAMEPAD_BUTTON_COUNT,
+} Mimas_Gamepad_Button;
+
+typedef enum Mimas_Gamepad_Axis {
+    MIMAS_GAMEPAD_AXIS_LEFT_X,
+    MIMAS_GAMEPAD_AXIS_LEFT_Y,
+    MIMAS_GAMEPAD_AXIS_RIGHT_X,
+    MIMAS_GAMEPAD_AXIS_RIGHT_Y,
+    MIMAS_GAMEPAD_AXIS_LEFT_TRIGGER,
+    MIMAS_GAMEPAD_AXIS_RIGHT_TRIGGER,
+    MIMAS_GAMEPAD_AXIS_COUNT,
+} Mimas_Gamepad_Axis;
+
+/*
+ * Sticks are in the range [-1, 1] with positive y pointing up. Triggers are in the range [0, 1].
+ * packet changes whenever the state of the device changes.
+ * timestamp_ns is the time at which the state has been sampled, as returned by mimas_get_time_ns.
+ */
+typedef struct Mimas_Gamepad_State {
+    mimas_bool connected;
+    mimas_u32 packet;
+    mimas_u64 timestamp_ns;
+    float axes[MIMAS_GAMEPAD_AXIS_COUNT];
+    mimas_u8 buttons[MIMAS_GAMEPAD_BUTTON_COUNT];
+} Mimas_Gamepad_State;
+
+/*
+ * Gamepads are sampled at device rate on a dedicated input thread that is started when gamepad input is enabled.
+ * The state may be queried from any thread without blocking the input thread.
+ * Returns: mimas_false if gamepad input is not available.
+ */
+MIMAS_API mimas_bool mimas_set_gamepad_input_enabled(mimas_bool enabled);
+/*
+ * Returns: mimas_true if the gamepad at index is connected.
+ */
+MIMAS_API mimas_bool mimas_get_gamepad_state(mimas_u32 index, Mimas_Gamepad_State* state);
+
+/*
+ * Monotonic time in nanoseconds.
+ */
+MIMAS_API mimas_u64 mimas_get_time_ns();
+
+typedef struct Mimas_Clipboard_Sink Mimas_Clipboard_Sink;
+
+/*
+ * Called when another application (or mimas_get_clipboard) requests the clipboard data in mime_type.
+ * The data is produced only on request and may be written to the sink in any number of chunks.
+ */
+typedef void (*mimas_clipboard_provide_callback)(char const* mime_type, Mimas_Clipboard_Sink* sink, void* user_data);
+/*
+ * Called once the offer has been replaced or the clipboard has been cleared and user_data will no longer be used.
+ */
+typedef void (*mimas_clipboard_release_callback)(void* user_data);
+
+typedef struct Mimas_Clipboard_Offer {
+    char const* const* mime_types;
+    mimas_u32 mime_type_count;
+    mimas_clipboard_provide_callback provide;
+    // Optional.
+    mimas_clipboard_release_callback release;
+    void* user_data;
+} Mimas_Clipboard_Offer;
+
+/*
+ * Called with consecutive chunks of the clipboard data. The chunk is valid only for the duration of the call.
+ * Return mimas_false to abort the transfer.
+ */
+typedef mimas_bool (*mimas_clipboard_receive_callback)(void const* data, mimas_u64 size, void* user_data);
+
+/*
+ * Mime types starting with "text/plain" are exchanged as UTF-8 text and are converted to the native text format.
+ * All other mime types are exchanged as opaque binary data.
+ *
+ * Returns: mimas_true if the offer has been placed on the clipboard.
+ */
+MIMAS_API mimas_bool mimas_set_clipboard(Mimas_Clipboard_Offer offer);
+MIMAS_API void mimas_write_clipboard_data(Mimas_Clipboard_Sink* sink, void const* data, mimas_u64 size);
+/*
+ * Returns: mimas_true if the data has been transferred completely.
+ */
+MIMAS_API mimas_bool mimas_get_clipboard(char const* mime_type, mimas_clipboard_receive_callback callback, void* user_data);
+MIMAS_API mimas_bool mimas_has_clipboard_data(char const* mime_type);
+
+#define MIMAS_HISTOGRAM_BUCKET_COUNT 32
+
+/*
+ * Log2-bucketed histogram. Bucket 0 counts values equal to 0, bucket i counts values in [2^(i-1), 2^i).
+ * The last bucket additionally counts all values that do not fit into any other bucket.
+ */
+typedef struct Mimas_Histogram {
+    mimas_u64 count;
+    mimas_u64 sum;
+    mimas_u64 max;
+    mimas_u64 buckets[MIMAS_HISTOGRAM_BUCKET_COUNT];
+} Mimas_Histogram;
+
+typedef enum Mimas_Callback_Type {
+    MIMAS_CALLBACK_WINDOW_ACTIVATE,
+    MIMAS_CALLBACK_CURSOR_POS,
+    MIMAS_CALLBACK_MOUSE_BUTTON,
+    MIMAS_CALLBACK_KEY,
+    MIMAS_CALLBACK_HITTEST,
+    MIMAS_CALLBACK_TEXT,
+    MIMAS_CALLBACK_RESIZE,
+    MIMAS_CALLBACK_CONTENT_SCALE,
+    MIMAS_CALLBACK_VISIBILITY,
+    MIMAS_CALLBACK_REDRAW,
+    MIMAS_CALLBACK_TYPE_COUNT,
+} Mimas_Callback_Type;
+
+/*
+ * All durations are in nanoseconds.
+ * polls, poll_time_ns, allocations and deallocations are process-wide and are always 0 in window stats.
+ * input_to_present_ns measures from the oldest key, mouse button, cursor or text event of a window that has not been presented yet
+ * to the return of the next mimas_swap_buffers of that window. Events start when mimas receives them from the system
+ * or, for mimas_inject_key, when they are injected. Frames are assumed to reflect all input received before they are swapped.
+ * The measurement ends when SwapBuffers returns, which is when the frame has been queued, not when it reaches the display.
+ * The time the frame spends in the driver's and compositor's queues afterwards is not included.
+ * examples/latency checks the assumption by finding the input in frames read back with mimas_begin_capture.
+ */
+typedef struct Mimas_Stats {
+    mimas_u64 polls;
+    mimas_u64 events;
+    mimas_u64 allocations;
+    mimas_u64 deallocations;
+    Mimas_Histogram events_per_poll;
+    Mimas_Histogram poll_time_ns;
+    Mimas_Histogram swap_time_ns;
+    Mimas_Histogram input_to_present_ns;
+    Mimas_Histogram callback_time_ns[MIMAS_CALLBACK_TYPE_COUNT];
+} Mimas_Stats;
+
+/*
+ * Stats collection is disabled by default. When disabled, the instrumented paths only check a flag.
+ * Stats may be read from any thread while they are being collected.
+ */
+MIMAS_API void mimas_set_stats_enabled(mimas_bool enabled);
+MIMAS_API mimas_bool mimas_get_stats_enabled();
+MIMAS_API void mimas_get_stats(Mimas_Stats* stats);
+MIMAS_API void mimas_get_window_stats(Mimas_Window* window, Mimas_Stats* stats);
+MIMAS_API void mimas_reset_stats();
+
+/*
+ * Queues a key event for window that the next mimas_poll_events delivers through the same path as system input.
+ * The event does not depend on focus and is not seen by other applications, which makes the input_to_present_ns
+ * stats of a render loop driven by injected keys reproducible. May be called from any thread, e.g. to emulate an input thread.
+ */
+MIMAS_API void mimas_inject_key(Mimas_Window* window, Mimas_Key key, Mimas_Key_Action action);
+
+/*
+ * Tracing records begin/end spans of mimas_poll_events, native event dispatch, user callbacks, buffer swaps and
+ * context switches into per-thread ring buffers. When a ring buffer fills up, the oldest spans are overwritten.
+ * events_per_thread is rounded up to a power of 2.
+ * Trace buffers are allocated on the first traced event of each thread and are kept until the process exits.
+ */
+MIMAS_API void mimas_enable_tracing(mimas_u32 events_per_thread);
+MIMAS_API void mimas_disable_tracing();
+
+/*
+ * Writes the recorded spans of all threads as Chrome trace-event JSON that can be opened in Perfetto.
+ * Returns: mimas_true on success, mimas_false if the file could not be written.
+ */
+MIMAS_API mimas_bool mimas_write_trace(char const* path);
+
+/*
+ * Frame exports publish frames into a ring of slots in named shared memory so that other processes can read them in place.
+ * A slot is not overwritten while a consumer holds it. If every slot is held, the frame is not published.
+ * The exporting process and the consumers do not need to use the same backend and consumers need not initialize mimas.
+ */
+typedef struct Mimas_Frame_Export Mimas_Frame_Export;
+typedef struct Mimas_Frame_Import Mimas_Frame_Import;
+
+typedef struct Mimas_Exported_Frame {
+    // RGBA8 pixels. Points into shared memory when acquired from an import.
+    void const* pixels;
+    mimas_i32 width;
+    mimas_i32 height;
+    // Size of a row in bytes.
+    mimas_i32 stride;
+    mimas_u64 timestamp_ns;
+    mimas_u64 frame_index;
+    // Increases by 1 with every published frame.
+    mimas_u64 sequence;
+    mimas_u32 slot;
+} Mimas_Exported_Frame;
+
+/*
+ * Creates a shared ring of slot_count slots, each large enough for a max_width x max_height RGBA8 frame.
+ * name identifies the export within the session and must not be in use by another export.
+ * The name of an export whose process exited without destroying it, e.g. after a crash, can be reused.
+ * Returns: NULL if the shared memory could not be created.
+ */
+MIMAS_API Mimas_Frame_Export* mimas_create_frame_export(char const* name, mimas_i32 max_width, mimas_i32 max_height, mimas_u32 slot_count);
+MIMAS_API void mimas_destroy_frame_export(Mimas_Frame_Export* frame_export);
+/*
+ * Copies the frame into a free slot, publishes it and wakes a consumer waiting in mimas_wait_exported_frame.
+ * pixels, width, height, stride, timestamp_ns and frame_index of frame are used.
+ * Returns: mimas_false if the frame is larger than the slots or every slot is held by consumers.
+ */
+MIMAS_API mimas_bool mimas_export_frame(Mimas_Frame_Export* frame_export, Mimas_Exported_Frame const* frame);
+
+/*
+ * Opens the export name that has been created by another process.
+ * Returns: NULL if there is no such export or its shared memory does not have the layout of an export.
+ */
+MIMAS_API Mimas_Frame_Import* mimas_open_frame_import(char const* name);
+MIMAS_API void mimas_close_frame_import(Mimas_Frame_Import* frame_import);
+/*
+ * Blocks until a frame newer than the last acquired one has been published or timeout_ms milliseconds have elapsed.
+ * Wakeups are delivered to one waiting consumer. Other consumers see the frame on their next call.
+ * Returns: mimas_true if a new frame is available.
+ */
+MIMAS_API mimas_bool mimas_wait_exported_frame(Mimas_Frame_Import* frame_import, mimas_u32 timeout_ms);
+/*
+ * Acquires the newest published frame without copying it. The slot is not reused until the frame is released.
+ * A consumer that exits without releasing its frames keeps their slots occupied until the export is recreated.
+ * Returns: mimas_false if no frame newer than the last acquired one is available.
+ */
+MIMAS_API mimas_bool mimas_acquire_exported_frame(Mimas_Frame_Import* frame_import, Mimas_Exported_Frame* frame);
+MIMAS_API void mimas_release_exported_frame(Mimas_Frame_Import* frame_import, Mimas_Exported_Frame const* frame);
+
 MIMAS_EXTERN_C_END
 
 #endif // !MIMAS_MIMAS_H_INCLUDE
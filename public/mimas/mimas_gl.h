@@ -12,11 +12,132 @@ typedef enum {
     MIMAS_GL_COMPATIBILITY_PROFILE,
 } Mimas_GL_Profile;
 
+typedef enum {
+    // Creates a debug context. Enables KHR_debug output at the cost of extra validation.
+    MIMAS_GL_CONTEXT_DEBUG = 0x1,
+    // Requests a context without error checking (KHR_no_error). Errors result in undefined behaviour instead of being reported.
+    // Cannot be combined with MIMAS_GL_CONTEXT_DEBUG or MIMAS_GL_CONTEXT_ROBUST.
+    // Ignored if the driver does not support it.
+    MIMAS_GL_CONTEXT_NO_ERROR = 0x2,
+    // Requests robust buffer access and notification of context loss.
+    // Context creation fails if the driver does not support it.
+    MIMAS_GL_CONTEXT_ROBUST = 0x4,
+    MIMAS_GL_CONTEXT_FORWARD_COMPATIBLE = 0x8,
+} Mimas_GL_Context_Flags;
+
+typedef enum {
+    // The context is flushed when it stops being current. Default.
+    MIMAS_GL_RELEASE_BEHAVIOR_FLUSH,
+    // The context is not flushed when it stops being current (KHR_context_flush_control).
+    // Ignored if the driver does not support it.
+    MIMAS_GL_RELEASE_BEHAVIOR_NONE,
+} Mimas_GL_Release_Behavior;
+
+typedef struct Mimas_GL_Context_Create_Info {
+    mimas_i32 version_major;
+    mimas_i32 version_minor;
+    Mimas_GL_Profile profile;
+    // Combination of Mimas_GL_Context_Flags.
+    mimas_u32 flags;
+    Mimas_GL_Release_Behavior release_behavior;
+    // Window whose framebuffer format the context is created for. The context can only be made current with windows
+    // of the same format, which windows created with the same framebuffer config share.
+    // NULL selects the format of windows created without a framebuffer config.
+    Mimas_Window* window;
+} Mimas_GL_Context_Create_Info;
+
 MIMAS_API mimas_bool mimas_init_with_gl();
 
+// Equivalent to mimas_create_gl_context_with_info without any flags.
 MIMAS_API Mimas_GL_Context* mimas_create_gl_context(mimas_i32 version_major, mimas_i32 version_minor, Mimas_GL_Profile profile);
+MIMAS_API Mimas_GL_Context* mimas_create_gl_context_with_info(Mimas_GL_Context_Create_Info const* info);
+/*
+ * A context that is current on another thread must be released on that thread first.
+ */
 MIMAS_API void mimas_destroy_gl_context(Mimas_GL_Context* ctx);
+
+/*
+ * Threading model: every thread has at most one current context, and a context is current on at most one thread.
+ * To render N windows from N threads, create the windows and poll events on the thread that called mimas_init_with_gl,
+ * then give each render thread its own context, made current with its window on that thread.
+ * A render thread may call mimas_make_context_current, mimas_swap_buffers, mimas_set_swap_interval,
+ * mimas_gl_get_proc_address and mimas_request_redraw, and none of them block the other render threads.
+ * Release the context of a window with mimas_make_context_current(window, NULL) on its render thread before the window is destroyed.
+ */
+
+/*
+ * Makes ctx current on the calling thread and binds it to window. ctx may be NULL to release the current context.
+ * Making the context and window that are already current on the calling thread current again returns without calling into the driver.
+ */
 MIMAS_API mimas_bool mimas_make_context_current(Mimas_Window* const window, Mimas_GL_Context* const ctx);
+// Returns the context made current on the calling thread through mimas_make_context_current or NULL.
+MIMAS_API Mimas_GL_Context* mimas_get_current_context();
+
+typedef void (*Mimas_GL_Proc)(void);
+
+/*
+ * Returns the entry point of the GL function name for the context that is current on the calling thread.
+ * Entry points may differ between contexts, therefore each context caches the entry points it has resolved.
+ * Returns: NULL if no context is current or the function is not available.
+ */
+MIMAS_API Mimas_GL_Proc mimas_gl_get_proc_address(char const* name);
+/*
+ * Resolves count entry points of the current context in one pass and writes them to procs.
+ * Intended for filling a generated dispatch table eagerly. Unavailable functions are set to NULL.
+ * The entry points are not added to the context's cache.
+ * Returns: The number of entry points that have been resolved.
+ */
+MIMAS_API mimas_u32 mimas_gl_load_procs(char const* const* names, mimas_u32 count, Mimas_GL_Proc* procs);
+
+typedef struct Mimas_Captured_Frame {
+    // Tightly packed RGBA8 pixels with the bottom row first, as returned by glReadPixels.
+    void const* pixels;
+    mimas_i32 width;
+    mimas_i32 height;
+    // Size of a row in bytes.
+    mimas_i32 stride;
+    // Time of the mimas_swap_buffers call that presented the frame, on the mimas_get_time_ns clock.
+    mimas_u64 timestamp_ns;
+    // Index of the frame since mimas_begin_capture. Gaps indicate frames that were presented but not captured,
+    // either because every slot was in flight or because the framebuffer was empty, e.g. while minimized.
+    mimas_u64 frame_index;
+    void* handle;
+} Mimas_Captured_Frame;
+
+/*
+ * Starts reading back every frame the window presents with mimas_swap_buffers.
+ * The back buffer is copied into a ring of buffer_count pixel pack buffers right before the swap and
+ * completed frames are retrieved with mimas_acquire_captured_frame. Neither blocks on the GPU.
+ * If all buffers are in flight at swap, the frame is dropped.
+ * Requires GL 3.2 and must be called with the context that renders to the window current.
+ * Returns: mimas_false if the window is already being captured or the context lacks the required functions.
+ */
+MIMAS_API mimas_bool mimas_begin_capture(Mimas_Window* window, mimas_u32 buffer_count);
+/*
+ * Stops the capture and frees its buffers. Must be called with the same context current as mimas_begin_capture
+ * and after every acquired frame has been released. Destroying the window ends the capture too,
+ * but leaves the GL buffers to be freed with the context.
+ */
+MIMAS_API void mimas_end_capture(Mimas_Window* window);
+/*
+ * Retrieves the oldest captured frame if the GPU has finished copying it. Must be called on the thread that
+ * renders to the window. The frame stays valid until it is passed to mimas_release_captured_frame.
+ * Returns: mimas_false if no frame is ready yet or the capture is bound to a frame export.
+ */
+MIMAS_API mimas_bool mimas_acquire_captured_frame(Mimas_Window* window, Mimas_Captured_Frame* frame);
+// Returns the frame's pixels to the capture. May be called from any thread, e.g. by an encoder thread.
+MIMAS_API void mimas_release_captured_frame(Mimas_Captured_Frame const* frame);
+/*
+ * Publishes the captured frames to frame_export instead of handing them out with mimas_acquire_captured_frame.
+ * Completed frames are copied from the mapped pixel pack buffer straight into a shared slot during the following
+ * mimas_swap_buffers calls, so the pixels are copied once on the CPU. Rows keep the bottom-first order of glReadPixels.
+ * Frames that do not fit the export or find every shared slot held by consumers are dropped.
+ * Pass NULL to return to mimas_acquire_captured_frame. The export must outlive the binding.
+ * Returns: mimas_false if the window is not being captured.
+ */
+MIMAS_API mimas_bool mimas_set_capture_export(Mimas_Window* window, Mimas_Frame_Export* frame_export);
+// Returns the number of frames that were skipped because all buffers were in flight or the frame export had no free slot.
+MIMAS_API mimas_u64 mimas_get_dropped_capture_frames(Mimas_Window* window);
 
 MIMAS_API void mimas_swap_buffers(Mimas_Window* window);
 MIMAS_API void mimas_set_swap_interval(mimas_i32);